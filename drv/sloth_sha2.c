@@ -54,99 +54,8 @@ void sha512_compress(void *v)
 
 #endif
 
-//  (Hmsg is not optimized as it is used only once.)
-
-//  Cat 1: Hmsg(R, PK.seed, PK.root, M) =
-//      MGF1-SHA-256(R || PK.seed || SHA-256(R ||PK.seed || PK.root || M), m)
-
-static void sha2_256_h_msg( slh_ctx_t *ctx,
-                            uint8_t *h,
-                            const uint8_t *r,
-                            const uint8_t *m, size_t m_sz)
-{
-    sha256_t sha2;
-    uint8_t mgf[16 + 16 + 32 + 4];
-    size_t  n = ctx->prm->n;
-
-    //  MGF1-SHA-256(R || PK.seed || ..
-    memcpy(mgf, r, n);
-    memcpy(mgf + n, ctx->pk_seed, n);
-
-    //  SHA-256(R || PK.seed || PK.root || M)
-    sha256_init(&sha2);
-    sha256_update(&sha2, r, n);
-    sha256_update(&sha2, ctx->pk_seed, n);
-    sha256_update(&sha2, ctx->pk_root, n);
-    sha256_update(&sha2, m, m_sz);
-    sha256_final(&sha2, mgf + 2 * n);
-
-    size_t mgf_sz = 2 * n + 32 + 4;
-    uint8_t *ctr = mgf + mgf_sz - 4;
-
-    //  MGF1 counter mode
-    for (size_t i = 0; i < ctx->prm->m; i += 32) {
-        uint32_t c = i / 32;
-        ctr[0] = c >> 24;
-        ctr[1] = (c >> 16) & 0xFF;
-        ctr[2] = (c >> 8) & 0xFF;
-        ctr[3] = c & 0xFF;
-
-        sha256_init(&sha2);
-        sha256_update(&sha2, mgf, mgf_sz);
-        if ((ctx->prm->m - i) >= 32) {
-            sha256_final(&sha2, h + i);
-        } else {
-            sha256_final(&sha2, mgf);
-            memcpy(h + i, mgf, ctx->prm->m - i);
-        }
-    }
-}
-
-//  Cat 3, 5: Hmsg(R, PK.seed, PK.root, M) =
-//      MGF1-SHA-512(R || PK.seed || SHA-512(R || PK.seed || PK.root || M), m)
-
-static void sha2_512_h_msg( slh_ctx_t *ctx,
-                            uint8_t *h,
-                            const uint8_t *r,
-                            const uint8_t *m, size_t m_sz)
-{
-    sha512_t sha2;
-    uint8_t mgf[32 + 32 + 64 + 4];
-    size_t  n = ctx->prm->n;
-
-    //  MGF1-SHA-512(R || PK.seed || ..
-    memcpy(mgf, r, n);
-    memcpy(mgf + n, ctx->pk_seed, n);
-
-    //  SHA-512(R || PK.seed || PK.root || M)
-    sha512_init(&sha2);
-    sha512_update(&sha2, r, n);
-    sha512_update(&sha2, ctx->pk_seed, n);
-    sha512_update(&sha2, ctx->pk_root, n);
-    sha512_update(&sha2, m, m_sz);
-    sha512_final(&sha2, mgf + 2 * n);
-
-    size_t mgf_sz = 2 * n + 64 + 4;
-    uint8_t *ctr = mgf + mgf_sz - 4;
-
-    //  MGF1 counter mode
-    for (size_t i = 0; i < ctx->prm->m; i += 64) {
-        uint32_t c = i / 64;
-        ctr[0] = c >> 24;
-        ctr[1] = (c >> 16) & 0xFF;
-        ctr[2] = (c >> 8) & 0xFF;
-        ctr[3] = c & 0xFF;
-
-        sha512_init(&sha2);
-        sha512_update(&sha2, mgf, mgf_sz);
-        if ((ctx->prm->m - i) >= 64) {
-            sha512_final(&sha2, h + i);
-        } else {
-            sha512_final(&sha2, mgf);
-            memcpy(h + i, mgf, ctx->prm->m - i);
-        }
-    }
-}
+//  (Hmsg and PRFmsg are not optimized as they are used only once; they
+//  are the generic ones in slh_msg.c.)
 
 //  Cat 1, 3, 5: PRF(PK.seed, SK.seed, ADRS) =
 //      Trunc_n(SHA-256(PK.seed || toByte(0, 64 − n) || ADRSc || SK.seed))
@@ -189,81 +98,6 @@ static void sha256_prf_32(  slh_ctx_t *ctx, uint8_t *h)
     block_copy_32(h, r32);
 }
 
-//  (PRFmsg is not optimized as it is used only once.)
-
-//  Cat 1: PRFmsg(SK.prf, opt_rand, M) =
-//      Trunc_n(HMAC-SHA-256(SK.prf, opt_rand || M))
-
-static void sha256_prf_msg( slh_ctx_t *ctx,
-                            uint8_t *h,
-                            const uint8_t *opt_rand,
-                            const uint8_t *m, size_t m_sz)
-{
-    unsigned i;
-    sha256_t sha2;
-    uint8_t pad[64], buf[32];
-    size_t  n = ctx->prm->n;
-
-    //  ipad
-    memcpy(pad, ctx->sk_prf, n);
-    for (i = 0; i < n; i++) {
-        pad[i] ^= 0x36;
-    }
-    memset(pad + n, 0x36, 64 - n);
-
-    sha256_init(&sha2);
-    sha256_update(&sha2, pad, 64);
-    sha256_update(&sha2, opt_rand, n);
-    sha256_update(&sha2, m, m_sz);
-    sha256_final(&sha2, buf);
-
-    //  opad
-    for (i = 0; i < 64; i++) {
-        pad[i] ^= 0x36 ^ 0x5C;
-    }
-
-    sha256_init(&sha2);
-    sha256_update(&sha2, pad, 64);
-    sha256_update(&sha2, buf, 32);
-    sha256_final_len(&sha2, h, n);
-}
-
-//  Cat 3, 5: PRFmsg(SK.prf, opt_rand, M) =
-//      Trunc_n(HMAC-SHA-512(SK.prf, opt_rand || M))
-
-static void sha512_prf_msg( slh_ctx_t *ctx,
-                            uint8_t *h, const uint8_t *opt_rand,
-                            const uint8_t *m, size_t m_sz)
-{
-    unsigned i;
-    sha512_t sha2;
-    uint8_t pad[128], buf[64];
-    size_t  n = ctx->prm->n;
-
-    //  ipad
-    memcpy(pad, ctx->sk_prf, n);
-    for (i = 0; i < n; i++) {
-        pad[i] ^= 0x36;
-    }
-    memset(pad + n, 0x36, 128 - n);
-
-    sha512_init(&sha2);
-    sha512_update(&sha2, pad, 128);
-    sha512_update(&sha2, opt_rand, n);
-    sha512_update(&sha2, m, m_sz);
-    sha512_final(&sha2, buf);
-
-    //  opad
-    for (i = 0; i < 128; i++) {
-        pad[i] ^= 0x36 ^ 0x5C;
-    }
-
-    sha512_init(&sha2);
-    sha512_update(&sha2, pad, 128);
-    sha512_update(&sha2, buf, 64);
-    sha512_final_len(&sha2, h, n);
-}
-
 //  Cat 1: T_l(PK.seed, ADRS, M1 ) =
 //      Trunc_n(SHA-256(PK.seed || toByte(0, 64 − n) || ADRSc || Ml ))
 
@@ -777,7 +611,10 @@ const slh_param_t slh_dsa_sha2_128s = { .alg_id ="SLH-DSA-SHA2-128s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_16,
     .wots_chain= sha256_wots_chain_16, .fors_hash= sha256_fors_hash_16,
     .h_msg= sha2_256_h_msg, .prf= sha256_prf_16, .prf_msg= sha256_prf_msg,
-    .h_f= sha256_f_16, .h_h= sha256_h_16, .h_t= sha256_tl_16
+    .h_f= sha256_f_16, .h_h= sha256_h_16, .h_t= sha256_tl_16,
+    .h_msg_init= sha2_256_h_msg_init, .h_msg_final= sha2_256_h_msg_final,
+    .prf_msg_init= sha256_prf_msg_init, .prf_msg_final= sha256_prf_msg_final,
+    .msg_update= sha256_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_128f = { .alg_id ="SLH-DSA-SHA2-128f",
@@ -785,7 +622,10 @@ const slh_param_t slh_dsa_sha2_128f = { .alg_id ="SLH-DSA-SHA2-128f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_16,
     .wots_chain= sha256_wots_chain_16, .fors_hash= sha256_fors_hash_16,
     .h_msg= sha2_256_h_msg, .prf= sha256_prf_16, .prf_msg= sha256_prf_msg,
-    .h_f= sha256_f_16, .h_h= sha256_h_16, .h_t= sha256_tl_16
+    .h_f= sha256_f_16, .h_h= sha256_h_16, .h_t= sha256_tl_16,
+    .h_msg_init= sha2_256_h_msg_init, .h_msg_final= sha2_256_h_msg_final,
+    .prf_msg_init= sha256_prf_msg_init, .prf_msg_final= sha256_prf_msg_final,
+    .msg_update= sha256_msg_update
 };
 
 //  10.3.   SLH-DSA Using SHA2 for Security Categories 3 and 5
@@ -795,7 +635,10 @@ const slh_param_t slh_dsa_sha2_192s = { .alg_id ="SLH-DSA-SHA2-192s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_24,
     .wots_chain= sha256_wots_chain_24, .fors_hash= sha256_fors_hash_24,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf_24, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f_24, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f_24, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_192f = { .alg_id ="SLH-DSA-SHA2-192f",
@@ -803,7 +646,10 @@ const slh_param_t slh_dsa_sha2_192f = { .alg_id ="SLH-DSA-SHA2-192f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_24,
     .wots_chain= sha256_wots_chain_24, .fors_hash= sha256_fors_hash_24,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf_24, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f_24, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f_24, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_256s = { .alg_id ="SLH-DSA-SHA2-256s",
@@ -811,7 +657,10 @@ const slh_param_t slh_dsa_sha2_256s = { .alg_id ="SLH-DSA-SHA2-256s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_32,
     .wots_chain= sha256_wots_chain_32, .fors_hash= sha256_fors_hash_32,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf_32, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f_32, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f_32, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_256f = { .alg_id ="SLH-DSA-SHA2-256f",
@@ -819,7 +668,10 @@ const slh_param_t slh_dsa_sha2_256f = { .alg_id ="SLH-DSA-SHA2-256f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain_32,
     .wots_chain= sha256_wots_chain_32, .fors_hash= sha256_fors_hash_32,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf_32, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f_32, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f_32, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 //  SLOTH_SHA256
@@ -33,25 +33,6 @@ void keccak_f1600(void *v)
 
 //  === 10.1.   SLH-DSA Using SHAKE
 
-//  Hmsg(R, PK.seed, PK.root, M) = SHAKE256(R || PK.seed || PK.root || M, 8m)
-
-static void shake_h_msg( slh_ctx_t *ctx,
-                            uint8_t *h,
-                            const uint8_t *r,
-                            const uint8_t *m, size_t m_sz)
-{
-    sha3_ctx_t sha3;
-    size_t  n = ctx->prm->n;
-
-    shake256_init(&sha3);
-    shake_update(&sha3, r, n);
-    shake_update(&sha3, ctx->pk_seed, n);
-    shake_update(&sha3, ctx->pk_root, n);
-    shake_update(&sha3, m, m_sz);
-
-    shake_out(&sha3, h, ctx->prm->m);
-}
-
 //  F(PK.seed, ADRS, M1 ) = SHAKE256(PK.seed || ADRS || M1, 8n)
 
 static void shake_f_16( slh_ctx_t *ctx,
@@ -182,24 +163,6 @@ static void shake_prf_32(slh_ctx_t *ctx, uint8_t *h)
 }
 
 
-//  PRFmsg (SK.prf, opt_rand, M) = SHAKE256(SK.prf || opt_rand || M, 8n)
-
-static void shake_prf_msg(  slh_ctx_t *ctx,
-                                uint8_t *h,
-                                const uint8_t *opt_rand,
-                                const uint8_t *m, size_t m_sz)
-{
-    sha3_ctx_t sha3;
-    size_t  n = ctx->prm->n;
-
-    shake256_init(&sha3);
-    shake_update(&sha3, ctx->sk_prf, n);
-    shake_update(&sha3, opt_rand, n);
-    shake_update(&sha3, m, m_sz);
-
-    shake_out(&sha3, h, n);
-}
-
 //  T_l(PK.seed, ADRS, M ) = SHAKE256(PK.seed || ADRS || Ml, 8n)
 
 static void shake_t( slh_ctx_t *ctx, uint8_t *h,
@@ -600,7 +563,10 @@ const slh_param_t slh_dsa_shake_128s = {    .alg_id ="SLH-DSA-SHAKE-128s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_16,
     .wots_chain= shake_wots_chain_16, .fors_hash= shake_fors_hash_16,
     .h_msg= shake_h_msg, .prf= shake_prf_16, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_16, .h_h= shake_h_16, .h_t= shake_t
+    .h_f= shake_f_16, .h_h= shake_h_16, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_128f = {    .alg_id ="SLH-DSA-SHAKE-128f",
@@ -608,7 +574,10 @@ const slh_param_t slh_dsa_shake_128f = {    .alg_id ="SLH-DSA-SHAKE-128f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_16,
     .wots_chain= shake_wots_chain_16, .fors_hash= shake_fors_hash_16,
     .h_msg= shake_h_msg, .prf= shake_prf_16, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_16, .h_h= shake_h_16, .h_t= shake_t
+    .h_f= shake_f_16, .h_h= shake_h_16, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_192s = {    .alg_id ="SLH-DSA-SHAKE-192s",
@@ -616,7 +585,10 @@ const slh_param_t slh_dsa_shake_192s = {    .alg_id ="SLH-DSA-SHAKE-192s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_24,
     .wots_chain= shake_wots_chain_24, .fors_hash= shake_fors_hash_24,
     .h_msg= shake_h_msg, .prf= shake_prf_24, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_24, .h_h= shake_h_24, .h_t= shake_t
+    .h_f= shake_f_24, .h_h= shake_h_24, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_192f = {    .alg_id ="SLH-DSA-SHAKE-192f",
@@ -624,7 +596,10 @@ const slh_param_t slh_dsa_shake_192f = {    .alg_id ="SLH-DSA-SHAKE-192f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_24,
     .wots_chain= shake_wots_chain_24, .fors_hash= shake_fors_hash_24,
     .h_msg= shake_h_msg, .prf= shake_prf_24, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_24, .h_h= shake_h_24, .h_t= shake_t
+    .h_f= shake_f_24, .h_h= shake_h_24, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_256s = {    .alg_id ="SLH-DSA-SHAKE-256s",
@@ -632,7 +607,10 @@ const slh_param_t slh_dsa_shake_256s = {    .alg_id ="SLH-DSA-SHAKE-256s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_32,
     .wots_chain= shake_wots_chain_32, .fors_hash= shake_fors_hash_32,
     .h_msg= shake_h_msg, .prf= shake_prf_32, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_32, .h_h= shake_h_32, .h_t= shake_t
+    .h_f= shake_f_32, .h_h= shake_h_32, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_256f = {    .alg_id ="SLH-DSA-SHAKE-256f",
@@ -640,7 +618,10 @@ const slh_param_t slh_dsa_shake_256f = {    .alg_id ="SLH-DSA-SHAKE-256f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain_32,
     .wots_chain= shake_wots_chain_32, .fors_hash= shake_fors_hash_32,
     .h_msg= shake_h_msg, .prf= shake_prf_32, .prf_msg= shake_prf_msg,
-    .h_f= shake_f_32, .h_h= shake_h_32, .h_t= shake_t
+    .h_f= shake_f_32, .h_h= shake_h_32, .h_t= shake_t,
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 //  SLOTH_KECCAK
@@ -345,6 +345,90 @@ int clk_test(const slh_param_t *iut, int n)
     return fail;
 }
 
+//  phase trace: the clock ticks of the top-level phases and the number of
+//  XMSS layers reported by slh_sign_trace() and slh_verify_trace()
+
+static const char *trc_phase[] = {
+    "PRF_msg", "H_msg", "FORS sign", "FORS pk",
+    "HT sign", "HT verify", "XMSS sign", "XMSS pk"
+};
+
+typedef struct {
+    const char *alg;
+    uint32_t    t0[8];                      //  start time of each phase
+    uint32_t    n[8];                       //  number of completed phases
+    int         err;                        //  unmatched events
+} trc_log_t;
+
+static void trc_event(  void *arg, int phase, uint32_t layer, bool end,
+                        uint64_t t)
+{
+    trc_log_t *tl = (trc_log_t *) arg;
+
+    (void) layer;
+    if (phase < 0 || phase >= 8) {
+        tl->err++;
+        return;
+    }
+    if (!end) {
+        tl->t0[phase] = (uint32_t) t;
+        return;
+    }
+    tl->n[phase]++;
+    if (phase < SLH_TR_XMSS_SIGN) {         //  (layers are not printed)
+        sio_puts("[CLK]\t");
+        sio_puts(tl->alg);
+        sio_putc(' ');
+        sio_put_dec((uint32_t) t - tl->t0[phase]);
+        sio_putc(' ');
+        sio_puts(trc_phase[phase]);
+        sio_putc('\n');
+    }
+}
+
+int trc_test(const slh_param_t *iut)
+{
+    int fail = 0;
+
+    uint8_t msg[2] = { 0, 0 };
+    size_t  msg_sz= 2, sig_sz = 0;
+
+    uint8_t pk[2 * 32] = { 0 };
+    uint8_t sk[4 * 32] = { 0 };
+    uint8_t sm[MAX_SIGN];
+    trc_log_t tl;
+    slh_trace_t tr = { trc_event, &tl };
+
+    rvkat_info(slh_alg_id(iut));
+
+    memset(&tl, 0, sizeof(tl));
+    tl.alg = slh_alg_id(iut);
+
+    fibo_a = 0x01234567;
+    fibo_b = 0xDEADBEEF;
+    slh_keygen(pk, sk, &clk_randombytes, iut);
+    sig_sz = slh_sign_trace(sm, msg, msg_sz, sk, &clk_randombytes, iut, &tr);
+    if (!slh_verify_trace(msg, msg_sz, sm, pk, iut, &tr)) {
+        fail += rvkat_chku32("slh_verify_trace()", true, false);
+    }
+
+    //  one signature and one verification
+    fail += rvkat_chku32("trace sig_sz", slh_sig_sz(iut), sig_sz);
+    fail += rvkat_chku32("trace err", 0, tl.err);
+    fail += rvkat_chku32("trace PRF_msg", 1, tl.n[SLH_TR_PRF_MSG]);
+    fail += rvkat_chku32("trace H_msg", 2, tl.n[SLH_TR_H_MSG]);
+    fail += rvkat_chku32("trace FORS sign", 1, tl.n[SLH_TR_FORS_SIGN]);
+    fail += rvkat_chku32("trace FORS pk", 2, tl.n[SLH_TR_FORS_PK]);
+    fail += rvkat_chku32("trace HT sign", 1, tl.n[SLH_TR_HT_SIGN]);
+    fail += rvkat_chku32("trace HT verify", 1, tl.n[SLH_TR_HT_VERIFY]);
+
+    //  d layers signed, d - 1 roots when signing and d when verifying
+    fail += rvkat_chku32("trace XMSS sign", true, tl.n[SLH_TR_XMSS_SIGN] > 0);
+    fail += rvkat_chku32("trace XMSS pk", 2 * tl.n[SLH_TR_XMSS_SIGN] - 1,
+                            tl.n[SLH_TR_XMSS_PK]);
+
+    return fail;
+}
 
 /*
     These are 32-bit cksums pairs (sk, sm) matching the the data of of the
@@ -469,6 +553,7 @@ int test_bench()
     iut_n = 1;
     fail += chk_test(   test_iut[iut_n],
                         kat_sksm_cksum[iut_n], 1);
+    fail += trc_test(test_iut[iut_n]);
     return fail;
 #endif
 
@@ -39,6 +39,8 @@ int test_leak()
     uint8_t sig[MAX_SIGN];
     slh_ctx_t   ctx;
 
+    memset(&ctx, 0, sizeof(ctx));           //  no optional features
+
     uint32_t trig = 0, cc = 0;
 
     uint8_t rando[32];
@@ -0,0 +1,81 @@
+//  hash_cpu.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Runtime selection of the hash kernels by CPU features.
+
+#include "hash_cpu.h"
+
+//  portable defaults; replaced at startup on x86
+
+hash_cpu_t hash_cpu = {
+    .level = HASH_CPU_C, .sha_ni = false, .sha256_xn = 8, .sha512_xn = 4
+};
+
+//  highest level supported by this CPU
+
+int hash_cpu_probe(void)
+{
+#ifdef HASH_CPU_X86
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2") ||
+        !__builtin_cpu_supports("bmi") ||
+        !__builtin_cpu_supports("bmi2"))
+        return HASH_CPU_C;
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl"))
+        return HASH_CPU_AVX512;
+    return HASH_CPU_AVX2;
+#endif
+    return HASH_CPU_C;
+}
+
+//  select kernels up to "level"
+
+int hash_cpu_select(int level)
+{
+    int max = hash_cpu_probe();
+
+    if (level > max)
+        level = max;
+    if (level < HASH_CPU_C)
+        level = HASH_CPU_C;
+
+    hash_cpu.level = level;
+    hash_cpu.sha_ni = false;
+#ifdef HASH_CPU_X86
+    //  SHA-NI does not need AVX2; it is off only if C is forced
+    if (level > HASH_CPU_C || max == HASH_CPU_C) {
+        hash_cpu.sha_ni = __builtin_cpu_supports("sha");
+    }
+#endif
+    //  16 and 8 lanes only pay off with AVX-512
+    hash_cpu.sha256_xn = level >= HASH_CPU_AVX512 ? 16 : 8;
+    hash_cpu.sha512_xn = level >= HASH_CPU_AVX512 ? 8 : 4;
+
+    return level;
+}
+
+//  name of the selected kernel level
+
+const char *hash_cpu_name(void)
+{
+    switch (hash_cpu.level) {
+        case HASH_CPU_AVX512:
+            return hash_cpu.sha_ni ? "avx512+sha" : "avx512";
+        case HASH_CPU_AVX2:
+            return hash_cpu.sha_ni ? "avx2+sha" : "avx2";
+        default:
+            return "c";
+    }
+}
+
+//  probe once before main()
+
+#ifdef HASH_CPU_X86
+__attribute__((constructor))
+static void hash_cpu_init(void)
+{
+    hash_cpu_select(HASH_CPU_AVX512);
+}
+#endif
@@ -0,0 +1,49 @@
+//  hash_cpu.h
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Runtime selection of the hash kernels by CPU features.
+
+#ifndef _HASH_CPU_H_
+#define _HASH_CPU_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//  x86 kernels are compiled with target attributes, independent of -march
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HASH_CPU_X86
+#endif
+
+//  kernel levels
+#define HASH_CPU_C      0                   //  portable C
+#define HASH_CPU_AVX2   1                   //  AVX2, BMI1, BMI2
+#define HASH_CPU_AVX512 2                   //  .. and AVX-512F, BW, VL
+
+typedef struct {
+    int         level;                      //  HASH_CPU_C .. HASH_CPU_AVX512
+    bool        sha_ni;                     //  x86 SHA extensions
+    uint32_t    sha256_xn;                  //  SHA-256 multi-buffer lanes
+    uint32_t    sha512_xn;                  //  SHA-512 multi-buffer lanes
+} hash_cpu_t;
+
+//  currently selected kernels; set up once at startup
+extern hash_cpu_t hash_cpu;
+
+//  highest level supported by this CPU
+int hash_cpu_probe(void);
+
+//  select kernels up to "level" (at most the probed one); returns level set
+int hash_cpu_select(int level);
+
+//  name of the selected kernel level
+const char *hash_cpu_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //  _HASH_CPU_H_
@@ -0,0 +1,515 @@
+//  host_bench.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Host benchmark for SLH-DSA key generation, signing, verification.
+
+#ifndef SLOTH
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "plat_local.h"
+#include "slh_dsa.h"
+#include "slh_ctx.h"
+#include "hash_cpu.h"
+
+//  limits
+
+#define BENCH_MAX_SIG   50000
+#define BENCH_MAX_LIST  16
+#define BENCH_MSG_SZ    32
+#define BENCH_PRIM_N    256                 //  primitive calls per repetition
+
+//  benchmark targets
+
+const slh_param_t *bench_iut[] = {
+    &slh_dsa_shake_128s,
+    &slh_dsa_shake_128f,
+    &slh_dsa_shake_192s,
+    &slh_dsa_shake_192f,
+    &slh_dsa_shake_256s,
+    &slh_dsa_shake_256f,
+    &slh_dsa_sha2_128s,
+    &slh_dsa_sha2_128f,
+    &slh_dsa_sha2_192s,
+    &slh_dsa_sha2_192f,
+    &slh_dsa_sha2_256s,
+    &slh_dsa_sha2_256f,
+    NULL
+};
+
+//  fast deterministic "random" bytes (as clk_randombytes() in test_bench.c)
+
+static uint32_t fibo_a = 0x01234567, fibo_b = 0xDEADBEEF;
+
+static int bench_randombytes(uint8_t *x, size_t xlen)
+{
+    size_t i;
+    uint32_t a = fibo_a, b = fibo_b;
+
+    for (i = 0; i < xlen; i++) {
+        x[i] = a >> 24;
+        a += b;
+        b += a;
+    }
+    fibo_a = a;
+    fibo_b = b;
+
+    return 0;
+}
+
+//  wall-clock time in nanoseconds
+
+static uint64_t bench_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+//  per-operation cycles and nanoseconds of each repetition
+
+typedef struct {
+    uint64_t    *cc;
+    uint64_t    *ns;
+    size_t      n;                          //  repetitions so far
+    size_t      ops;                        //  total operations
+    uint64_t    ns_tot;                     //  total wall-clock time
+    uint64_t    cc0, ns0;
+} bench_t;
+
+static void bench_start(bench_t *b)
+{
+    b->ns0 = bench_ns();
+    b->cc0 = plat_get_cycle();
+}
+
+static void bench_stop(bench_t *b, size_t ops)
+{
+    uint64_t cc = plat_get_cycle() - b->cc0;
+    uint64_t ns = bench_ns() - b->ns0;
+
+    b->cc[b->n] = cc / ops;
+    b->ns[b->n] = ns / ops;
+    b->n++;
+    b->ops += ops;
+    b->ns_tot += ns;
+}
+
+//  percentile p of sorted v[0 .. n - 1] (nearest rank)
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *((const uint64_t *) a), y = *((const uint64_t *) b);
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static uint64_t bench_pct(const uint64_t *v, size_t n, int p)
+{
+    size_t i = (n * p + 99) / 100;
+    return v[i > 0 ? i - 1 : 0];
+}
+
+//  one machine-readable result line; returns the median cycles
+
+static uint64_t bench_report(   bench_t *b, const char *alg, const char *op,
+                                uint32_t threads, size_t batch)
+{
+    uint64_t cc;
+
+    qsort(b->cc, b->n, sizeof(uint64_t), cmp_u64);
+    qsort(b->ns, b->n, sizeof(uint64_t), cmp_u64);
+
+    printf("%s,%s,%s,%u,%zu,%zu,%llu,%llu,%llu,%llu,%.2f\n",
+            alg, hash_cpu_name(), op, threads, batch, b->n,
+            (unsigned long long) bench_pct(b->cc, b->n, 50),
+            (unsigned long long) bench_pct(b->cc, b->n, 90),
+            (unsigned long long) bench_pct(b->cc, b->n, 99),
+            (unsigned long long) bench_pct(b->ns, b->n, 50),
+            1E9 * ((double) b->ops) / ((double) b->ns_tot));
+    fflush(stdout);
+
+    cc = bench_pct(b->cc, b->n, 50);
+    b->n = 0;
+    b->ops = 0;
+    b->ns_tot = 0;
+
+    return cc;
+}
+
+//  all operations for one (parameter set, threads, batch)
+
+static int bench_iut_run(   const slh_param_t *prm, size_t reps,
+                            uint32_t threads, size_t batch)
+{
+    int fail = 0;
+    size_t i, j;
+    size_t pk_sz = slh_pk_sz(prm), sk_sz = slh_sk_sz(prm);
+    const char *alg = slh_alg_id(prm);
+    slh_par_t *par = NULL;
+    bench_t b;
+    uint8_t *pk, *sk, *sig, *m;
+    bool *ok;
+    slh_stuple_t *st;
+    slh_vtuple_t *vt;
+
+    pk  = (uint8_t *) malloc(batch * pk_sz);
+    sk  = (uint8_t *) malloc(batch * sk_sz);
+    sig = (uint8_t *) malloc(batch * BENCH_MAX_SIG);
+    m   = (uint8_t *) malloc(batch * BENCH_MSG_SZ);
+    ok  = (bool *) malloc(batch * sizeof(bool));
+    st  = (slh_stuple_t *) malloc(batch * sizeof(slh_stuple_t));
+    vt  = (slh_vtuple_t *) malloc(batch * sizeof(slh_vtuple_t));
+    b.cc = (uint64_t *) malloc(reps * sizeof(uint64_t));
+    b.ns = (uint64_t *) malloc(reps * sizeof(uint64_t));
+
+    if (pk == NULL || sk == NULL || sig == NULL || m == NULL || ok == NULL ||
+        st == NULL || vt == NULL || b.cc == NULL || b.ns == NULL) {
+        fprintf(stderr, "[FAIL] out of memory.\n");
+        fail++;
+        goto done;
+    }
+    b.n = 0;
+    b.ops = 0;
+    b.ns_tot = 0;
+
+    if (threads > 1) {
+        par = slh_pool_new(threads);
+    }
+
+    bench_randombytes(m, batch * BENCH_MSG_SZ);
+    for (j = 0; j < batch; j++) {
+        st[j].sig   = sig + j * BENCH_MAX_SIG;
+        st[j].m     = m + j * BENCH_MSG_SZ;
+        st[j].m_sz  = BENCH_MSG_SZ;
+        st[j].sk    = sk + j * sk_sz;
+        st[j].prm   = prm;
+        vt[j].m     = st[j].m;
+        vt[j].m_sz  = BENCH_MSG_SZ;
+        vt[j].sig   = st[j].sig;
+        vt[j].pk    = pk + j * pk_sz;
+        vt[j].prm   = prm;
+    }
+
+    //  key generation
+    for (i = 0; i < reps; i++) {
+        bench_start(&b);
+        if (batch == 1) {
+            slh_keygen_par(pk, sk, bench_randombytes, prm, par);
+        } else {
+            slh_keygen_batch(pk, sk, batch, bench_randombytes, prm, par);
+        }
+        bench_stop(&b, batch);
+    }
+    bench_report(&b, alg, batch == 1 ? "keygen" : "keygen_batch",
+                    threads, batch);
+
+    //  signing
+    for (i = 0; i < reps; i++) {
+        bench_start(&b);
+        if (batch == 1) {
+            slh_sign_par(   sig, m, BENCH_MSG_SZ, sk,
+                            bench_randombytes, prm, par);
+        } else {
+            slh_sign_batch(st, batch, bench_randombytes, par);
+        }
+        bench_stop(&b, batch);
+    }
+    bench_report(&b, alg, batch == 1 ? "sign" : "sign_batch",
+                    threads, batch);
+
+    //  verification
+    for (i = 0; i < reps; i++) {
+        bench_start(&b);
+        if (batch == 1) {
+            ok[0] = slh_verify(m, BENCH_MSG_SZ, sig, pk, prm);
+        } else {
+            slh_verify_batch(ok, vt, batch, par);
+        }
+        bench_stop(&b, batch);
+        for (j = 0; j < batch; j++) {
+            if (!ok[j]) {
+                fprintf(stderr, "[FAIL] %s verify %zu.\n", alg, j);
+                fail++;
+            }
+        }
+    }
+    //  slh_verify() does not use the pool
+    bench_report(&b, alg, batch == 1 ? "verify" : "verify_batch",
+                    batch == 1 ? 1 : threads, batch);
+
+done:
+    slh_pool_free(par);
+    free(b.ns);
+    free(b.cc);
+    free(vt);
+    free(st);
+    free(ok);
+    free(m);
+    free(sig);
+    free(sk);
+    free(pk);
+
+    return fail;
+}
+
+//  === Primitive-level microbenchmarks ("-p")
+
+//  time BENCH_PRIM_N executions of "stmt", each one "per" operations
+
+#define BENCH_PRIM(b, reps, alg, op, per, stmt) {                   \
+    size_t r_, c_;                                                  \
+    for (r_ = 0; r_ < (reps); r_++) {                               \
+        bench_start(b);                                             \
+        for (c_ = 0; c_ < BENCH_PRIM_N; c_++) {                     \
+            stmt;                                                   \
+        }                                                           \
+        bench_stop(b, BENCH_PRIM_N * (per));                        \
+    }                                                               \
+    cc = bench_report(b, alg, op, 1, per);                          }
+
+//  raw compression functions and permutations, per lane
+
+static void bench_kernels(bench_t *b, size_t reps)
+{
+    uint64_t cc;
+    uint64_t st[25 * 16];
+
+    memset(st, 0, sizeof(st));
+    BENCH_PRIM(b, reps, "kernel", "keccak_f1600", 1, keccak_f1600(st))
+    BENCH_PRIM(b, reps, "kernel", "keccak_f1600_x4", 4, keccak_f1600_x4(st))
+    BENCH_PRIM(b, reps, "kernel", "sha256_compress", 1, sha256_compress(st))
+    BENCH_PRIM(b, reps, "kernel", "sha256_compress_x8", 8,
+                sha256_compress_x8(st))
+    BENCH_PRIM(b, reps, "kernel", "sha256_compress_x16", 16,
+                sha256_compress_x16(st))
+    BENCH_PRIM(b, reps, "kernel", "sha512_compress", 1, sha512_compress(st))
+    BENCH_PRIM(b, reps, "kernel", "sha512_compress_x4", 4,
+                sha512_compress_x4(st))
+    BENCH_PRIM(b, reps, "kernel", "sha512_compress_x8", 8,
+                sha512_compress_x8(st))
+    (void) cc;
+}
+
+//  median cycles of the primitives used by the cost model
+
+typedef struct {
+    double  f, h, prf, chain;               //  scalar; chain per step
+    double  t_len, t_k;                     //  T_len (WOTS+ pk), T_k (FORS)
+    double  f_x, h_x, prf_x, chain_x;       //  multi-buffer, per lane
+} bench_cost_t;
+
+//  Predicted cycles from the primitive costs. Signing computes the k FORS
+//  trees and d XMSS trees in full, plus on average (w-1)/2 chain steps per
+//  WOTS+ signature; verification does a FORS leaf and path per tree, and
+//  the remaining chain steps, T_len, and a path per layer.
+
+static void bench_model(const slh_param_t *prm, const bench_cost_t *c)
+{
+    const char *alg = slh_alg_id(prm);
+    double len = 2 * prm->n + 3;            //  lg_w = 4 in all sets
+    double w1 = 15, leaf, tree, fors, sign, verify;
+    double t = 1 << prm->a, x = 1 << prm->hp;
+
+    leaf    = len * (c->prf_x + w1 * c->chain_x) + c->t_len;
+    tree    = x * leaf + (x - 1) * c->h_x;
+    fors    = prm->k * (t * (c->prf_x + c->f_x) + (t - 1) * c->h_x) + c->t_k;
+    sign    = fors + prm->d * (tree + len * (c->prf_x + 0.5 * w1 * c->f_x));
+    verify  = prm->k * (c->f + prm->a * c->h) + c->t_k +
+                prm->d * (len * 0.5 * w1 * c->chain + c->t_len +
+                            prm->hp * c->h);
+
+    printf("%s,%s,model_sign,1,1,0,%.0f,0,0,0,0\n",
+            alg, hash_cpu_name(), sign);
+    printf("%s,%s,model_verify,1,1,0,%.0f,0,0,0,0\n",
+            alg, hash_cpu_name(), verify);
+}
+
+//  each tweakable hash of one parameter set, the cost model, and measured
+//  signing and verification for comparison
+
+static int bench_prim_run(const slh_param_t *prm, bench_t *b, size_t reps)
+{
+    const char *alg = slh_alg_id(prm);
+    size_t n = prm->n, len = 2 * n + 3, j;
+    uint8_t sk[4 * SLH_MAX_N], h[SLH_MAX_N];
+    uint8_t buf[SLH_MAX_LEN * SLH_MAX_N];
+    uint8_t out[SLH_MAX_X][SLH_MAX_N];
+    slh_lane_t lane[SLH_MAX_X];
+    slh_ctx_t ctx;
+    bench_cost_t c;
+    uint64_t cc;
+
+    bench_randombytes(sk, sizeof(sk));
+    bench_randombytes(buf, sizeof(buf));
+    memset(&ctx, 0, sizeof(ctx));
+    prm->mk_ctx(&ctx, NULL, sk, prm);
+
+    BENCH_PRIM(b, reps, alg, "h_f", 1, prm->h_f(&ctx, h, buf))
+    c.f = cc;
+    BENCH_PRIM(b, reps, alg, "h_h", 1, prm->h_h(&ctx, h, buf, buf + n))
+    c.h = cc;
+    BENCH_PRIM(b, reps, alg, "h_t_len", 1, prm->h_t(&ctx, h, buf, len * n))
+    c.t_len = cc;
+    BENCH_PRIM(b, reps, alg, "h_t_k", 1,
+                prm->h_t(&ctx, h, buf, prm->k * n))
+    c.t_k = cc;
+    BENCH_PRIM(b, reps, alg, "prf", 1, prm->prf(&ctx, h))
+    c.prf = cc;
+    BENCH_PRIM(b, reps, alg, "chain", 15, prm->chain(&ctx, h, buf, 0, 15))
+    c.chain = cc;
+    BENCH_PRIM(b, reps, alg, "wots_chain", 1, prm->wots_chain(&ctx, h, 15))
+    BENCH_PRIM(b, reps, alg, "fors_hash", 1, prm->fors_hash(&ctx, h, 1))
+
+    //  multi-buffer versions, per lane
+    c.f_x       = c.f;
+    c.h_x       = c.h;
+    c.prf_x     = c.prf;
+    c.chain_x   = c.chain;
+    if (prm->prf_x != NULL && prm->h_f_x != NULL &&
+        prm->h_h_x != NULL && prm->chain_x != NULL) {
+        for (j = 0; j < SLH_MAX_X; j++) {
+            lane[j].ctx = &ctx;
+            lane[j].adrs = *ctx.adrs;
+            lane[j].adrs.u8[23] = j;        //  chain address
+            lane[j].h   = out[j];
+            lane[j].m1  = buf + j * n;
+            lane[j].m2  = buf + (j + 1) * n;
+        }
+        BENCH_PRIM(b, reps, alg, "h_f_x", SLH_MAX_X,
+                    prm->h_f_x(lane, SLH_MAX_X))
+        c.f_x = cc;
+        BENCH_PRIM(b, reps, alg, "h_h_x", SLH_MAX_X,
+                    prm->h_h_x(lane, SLH_MAX_X))
+        c.h_x = cc;
+        BENCH_PRIM(b, reps, alg, "prf_x", SLH_MAX_X,
+                    prm->prf_x(lane, SLH_MAX_X))
+        c.prf_x = cc;
+        BENCH_PRIM(b, reps, alg, "chain_x", SLH_MAX_X * 15,
+                    prm->chain_x(lane, SLH_MAX_X, 15))
+        c.chain_x = cc;
+    }
+
+    bench_model(prm, &c);
+
+    return bench_iut_run(prm, reps, 1, 1);
+}
+
+//  parse a comma-separated list of positive integers
+
+static size_t bench_list(uint32_t *v, const char *s)
+{
+    size_t n = 0;
+    char *p;
+
+    while (n < BENCH_MAX_LIST && *s != 0) {
+        v[n] = (uint32_t) strtoul(s, &p, 0);
+        if (p == s || v[n] == 0)
+            return 0;
+        n++;
+        s = *p == ',' ? p + 1 : p;
+    }
+    return n;
+}
+
+//  parameter set selected by name (all if none given)
+
+static bool bench_use(const slh_param_t *prm, const char **sel, int sel_n)
+{
+    int i;
+
+    for (i = 0; i < sel_n; i++) {
+        if (strstr(slh_alg_id(prm), sel[i]) != NULL)
+            return true;
+    }
+    return sel_n == 0;
+}
+
+int main(int argc, char **argv)
+{
+    int fail = 0;
+    int i, k, level;
+    size_t reps = 5;
+    uint32_t thr[BENCH_MAX_LIST] = { 1 }, bat[BENCH_MAX_LIST] = { 1 };
+    size_t thr_n = 1, bat_n = 1, ti, bi;
+    const char *sel[BENCH_MAX_LIST];
+    int sel_n = 0;
+    bool prim = false;
+    bench_t b;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            reps = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            thr_n = bench_list(thr, argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            bat_n = bench_list(bat, argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0) {
+            prim = true;
+        } else if (argv[i][0] != '-' && sel_n < BENCH_MAX_LIST) {
+            sel[sel_n++] = argv[i];
+        } else {
+            thr_n = 0;
+            break;
+        }
+    }
+    if (reps == 0 || thr_n == 0 || bat_n == 0) {
+        fprintf(stderr,
+            "Usage: %s [-n reps] [-t threads,..] [-b batch,..] [-p] [alg ..]\n"
+            "  Results are CSV lines; alg selects parameter sets whose name"
+            " contains it.\n"
+            "  -p times the hash primitives with each supported kernel level"
+            " instead.\n", argv[0]);
+        return 1;
+    }
+
+    fprintf(stderr, "[INFO] kernels %s, %zu repetitions.\n",
+            hash_cpu_name(), reps);
+    printf("alg,kernels,op,threads,batch,reps,"
+            "cyc_med,cyc_p90,cyc_p99,ns_med,ops_sec\n");
+
+    //  primitives, cost model, and sign/verify with each kernel level
+    if (prim) {
+        b.cc = (uint64_t *) malloc(reps * sizeof(uint64_t));
+        b.ns = (uint64_t *) malloc(reps * sizeof(uint64_t));
+        if (b.cc == NULL || b.ns == NULL) {
+            fprintf(stderr, "[FAIL] out of memory.\n");
+            return 1;
+        }
+        b.n = 0;
+        b.ops = 0;
+        b.ns_tot = 0;
+
+        for (level = hash_cpu_probe(); level >= HASH_CPU_C; level--) {
+            hash_cpu_select(level);
+            bench_kernels(&b, reps);
+            for (k = 0; bench_iut[k] != NULL; k++) {
+                if (bench_use(bench_iut[k], sel, sel_n)) {
+                    fail += bench_prim_run(bench_iut[k], &b, reps);
+                }
+            }
+        }
+        hash_cpu_select(hash_cpu_probe());
+        free(b.ns);
+        free(b.cc);
+        return fail;
+    }
+
+    for (k = 0; bench_iut[k] != NULL; k++) {
+        if (!bench_use(bench_iut[k], sel, sel_n))
+            continue;
+        for (ti = 0; ti < thr_n; ti++) {
+            for (bi = 0; bi < bat_n; bi++) {
+                fail += bench_iut_run(bench_iut[k], reps, thr[ti], bat[bi]);
+            }
+        }
+    }
+
+    return fail;
+}
+
+//  SLOTH
+#endif
@@ -12,6 +12,10 @@
 
 #include "slh_dsa.h"
 #include "kat_drbg.h"
+#include "hash_cpu.h"
+#include "slh_ctx.h"
+#include "slh_adrs.h"
+#include "slh_count.h"
 
 #ifndef KATNUM
 #define KATNUM 100
@@ -20,6 +24,33 @@
 //  fake test drbg state
 aes256_ctr_drbg_t kat_drbg, iut_drbg;
 
+//  thread pool for the parallel signing tests
+slh_par_t *iut_par = NULL;
+slh_vcache_t *iut_vc = NULL;
+
+//  counting wrapper around the built-in verification cache
+slh_vcache_t *iut_vc_in = NULL;
+size_t iut_vc_hits = 0;
+
+static bool iut_vc_get( void *cache, uint8_t *val, size_t val_sz,
+                        const uint8_t *key, size_t key_sz)
+{
+    (void) cache;
+    if (!iut_vc_in->get(iut_vc_in->cache, val, val_sz, key, key_sz))
+        return false;
+    iut_vc_hits++;
+    return true;
+}
+
+static void iut_vc_put( void *cache, const uint8_t *val, size_t val_sz,
+                        const uint8_t *key, size_t key_sz)
+{
+    (void) cache;
+    iut_vc_in->put(iut_vc_in->cache, val, val_sz, key, key_sz);
+}
+
+slh_vcache_t iut_vc_count = { iut_vc_get, iut_vc_put, NULL, 0 };
+
 //  for the callback interface
 int iut_randombytes(uint8_t *x, size_t xlen)
 {
@@ -27,6 +58,26 @@ int iut_randombytes(uint8_t *x, size_t xlen)
     return 0;
 }
 
+//  message reader for slh_sign_read(); reads in small pieces
+typedef struct {
+    const uint8_t *m;
+    size_t m_sz;
+} iut_msg_t;
+
+static size_t iut_read(void *arg, uint8_t *buf, size_t sz, uint64_t pos)
+{
+    const iut_msg_t *msg = (const iut_msg_t *) arg;
+
+    if (pos >= msg->m_sz)
+        return 0;
+    if (sz > 7)
+        sz = 7;
+    if (sz > msg->m_sz - pos)
+        sz = msg->m_sz - pos;
+    memcpy(buf, msg->m + pos, sz);
+    return sz;
+}
+
 static void kat_hex(FILE *fh, const char *label,
                     const uint8_t *x, size_t xlen)
 {
@@ -51,7 +102,14 @@ int kat_test(const slh_param_t *iut, int katnum)
 
     uint8_t pk[2 * 32] = { 0 };
     uint8_t sk[4 * 32] = { 0 };
+    uint8_t pk2[2 * 2 * 32], pk3[2 * 32];
+    uint8_t sk2[2 * 4 * 32], sk3[4 * 32];
     uint8_t sm[50000 + 33 * KATNUM];
+    uint8_t sm2[50000];
+    uint8_t sm3[50000];
+    aes256_ctr_drbg_t drbg_copy;
+    slh_skey_t *skey;
+    slh_pkey_t *pkey;
 
     snprintf(fn, sizeof(fn), "%s-%d.rsp", slh_alg_id(iut), katnum);
     fh = fopen(fn, "w");
@@ -99,8 +157,74 @@ int kat_test(const slh_param_t *iut, int katnum)
         kat_hex(fh, "pk", pk, pk_sz);
         kat_hex(fh, "sk", sk, sk_sz);
 
+        drbg_copy = iut_drbg;
+
+        //  batch of two; the first one is the same as above
+        aes256ctr_xof_init(&iut_drbg, seed);
+        slh_keygen_batch(pk2, sk2, 2, &iut_randombytes, iut, iut_par);
+        if (memcmp(pk, pk2, pk_sz) != 0 || memcmp(sk, sk2, sk_sz) != 0) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_keygen_batch() mismatch.\n");
+        }
+
+        //  .. and the second one the same as a multi-threaded keygen (the
+        //  drbg state after the first keygen is exactly where it starts)
+        iut_drbg = drbg_copy;
+        slh_keygen_par(pk3, sk3, &iut_randombytes, iut, iut_par);
+        if (memcmp(pk2 + pk_sz, pk3, pk_sz) != 0 ||
+            memcmp(sk2 + sk_sz, sk3, sk_sz) != 0) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_keygen_par() mismatch.\n");
+        }
+        iut_drbg = drbg_copy;
+
         sm_sz = slh_sign(sm, msg, msg_sz, sk, &iut_randombytes, iut);
 
+        //  multi-threaded signature must be identical
+        if (iut_par != NULL) {
+            iut_drbg = drbg_copy;
+            if (slh_sign_par(sm2, msg, msg_sz, sk, &iut_randombytes,
+                                iut, iut_par) != sm_sz ||
+                memcmp(sm, sm2, sm_sz) != 0) {
+                fail++;
+                fprintf(stderr, "[FAIL] slh_sign_par() mismatch.\n");
+            }
+        }
+
+        //  .. as must the one made with precomputed top layer trees
+        skey = slh_skey_new(sk, iut, 1 << 18, iut_par);
+        iut_drbg = drbg_copy;
+        if (skey == NULL ||
+            slh_sign_skey(  sm2, msg, msg_sz, skey, &iut_randombytes,
+                            NULL) != sm_sz ||
+            memcmp(sm, sm2, sm_sz) != 0) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_sign_skey() mismatch.\n");
+        }
+        slh_skey_free(skey);
+
+        //  streaming message
+        iut_msg_t rd_msg = { msg, msg_sz };
+        iut_drbg = drbg_copy;
+        if (slh_sign_read(  sm2, iut_read, &rd_msg, sk, &iut_randombytes,
+                            iut) != sm_sz ||
+            memcmp(sm, sm2, sm_sz) != 0) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_sign_read() mismatch.\n");
+        }
+
+        //  batch of two; the first one is the same as above
+        slh_stuple_t st[2] = {
+            { sm2, msg, msg_sz, sk, iut },
+            { sm3, msg, msg_sz, sk, iut } };
+        iut_drbg = drbg_copy;
+        if (slh_sign_batch(st, 2, &iut_randombytes, iut_par) != 2 ||
+            memcmp(sm, sm2, sm_sz) != 0 ||
+            !slh_verify(msg, msg_sz, sm3, pk, iut)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_sign_batch() mismatch.\n");
+        }
+
         memcpy(sm + sm_sz, msg, msg_sz);
         sm_sz += msg_sz;
         fprintf(fh, "smlen = %zu\n", sm_sz);
@@ -114,6 +238,50 @@ int kat_test(const slh_param_t *iut, int katnum)
             fprintf(stderr, "[FAIL] slh_verify() fails.\n");
         }
 
+        //  verify twice with a cache; the second time it is used
+        for (int i = 0; iut_vc != NULL && i < 2; i++) {
+            size_t hits = iut_vc_hits;
+            if (!slh_verify_vc(sm + sig_sz, msg_sz, sm, pk, iut, iut_vc)) {
+                fail++;
+                fprintf(stderr, "[FAIL] slh_verify_vc() fails.\n");
+            }
+            if (i == 1 && iut_vc_hits == hits) {
+                fail++;
+                fprintf(stderr, "[FAIL] slh_verify_vc() cache not used.\n");
+            }
+        }
+
+        //  streaming verification, in pieces of 10 bytes
+        slh_vstream_t *vs = slh_verify_init(sm, pk, iut);
+        for (size_t i = 0; vs != NULL && i < msg_sz; i += 10) {
+            slh_verify_update(vs, sm + sig_sz + i,
+                                msg_sz - i < 10 ? msg_sz - i : 10);
+        }
+        if (!slh_verify_final(vs)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_final() fails.\n");
+        }
+
+        //  prepared verification key
+        pkey = slh_pkey_new(pk, iut);
+        if (pkey == NULL ||
+            !slh_verify_pkey(sm + sig_sz, msg_sz, sm, pkey, NULL)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_pkey() fails.\n");
+        }
+
+        //  pre-hash; the signature is bound to the hash and context string
+        uint8_t ph_m[64];
+        int ph = SLH_PH_SHA2_256 + (count & 3);
+        slh_ph_digest(ph_m, msg, msg_sz, ph);
+        if (slh_ph_sign(sm3, ph_m, ph, seed, 8, sk, &iut_randombytes,
+                        iut) != sig_sz ||
+            !slh_ph_verify(ph_m, ph, seed, 8, sm3, pk, iut) ||
+            slh_ph_verify(ph_m, ph, seed, 7, sm3, pk, iut)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_ph_verify() fails.\n");
+        }
+
         //  flip random bit
         uint32_t xbit = ((uint32_t) seed[4]) +
                         (((uint32_t) seed[5]) <<  8) +
@@ -125,12 +293,357 @@ int kat_test(const slh_param_t *iut, int katnum)
             fail++;
             fprintf(stderr, "[FAIL] slh_verify() forgery bit= %u.\n", xbit);
         }
+        if (iut_vc != NULL &&
+            slh_verify_vc(sm + sig_sz, msg_sz, sm, pk, iut, iut_vc)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_vc() forgery bit= %u.\n", xbit);
+        }
+        vs = slh_verify_init(sm, pk, iut);
+        if (vs != NULL) {
+            slh_verify_update(vs, sm + sig_sz, msg_sz);
+        }
+        if (slh_verify_final(vs)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_final() forgery bit= %u.\n",
+                    xbit);
+        }
+        if (pkey != NULL &&
+            slh_verify_pkey(sm + sig_sz, msg_sz, sm, pkey, NULL)) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_pkey() forgery bit= %u.\n",
+                    xbit);
+        }
+        slh_pkey_free(pkey);
+
+        //  batch with the forgery and two copies of the valid signature
+        slh_vtuple_t vt[3] = {
+            { sm + sig_sz, msg_sz, sm, pk, iut },
+            { msg, msg_sz, sm2, pk, iut },
+            { msg, msg_sz, sm2, pk, iut } };
+        bool vt_ok[3];
+        if (slh_verify_batch(vt_ok, vt, 3, iut_par) != 2 ||
+            vt_ok[0] || !vt_ok[1] || !vt_ok[2]) {
+            fail++;
+            fprintf(stderr, "[FAIL] slh_verify_batch() bit= %u.\n", xbit);
+        }
     }
     fclose(fh);
 
     return fail;
 }
 
+//  deterministic "random" bytes for the kernel comparison
+
+static int cpu_rbg(uint8_t *x, size_t xlen)
+{
+    size_t i;
+    for (i = 0; i < xlen; i++) {
+        x[i] = (uint8_t) (i * 0x9D + 0x3B);
+    }
+    return 0;
+}
+
+//  all hash kernel levels supported by the CPU create the same signatures
+
+int kat_cpu_test(const slh_param_t *iut)
+{
+    int fail = 0;
+    int level, max;
+    const uint8_t m[3] = { 'a', 'b', 'c' };
+    uint8_t pk[2 * 32], sk[4 * 32];
+    static uint8_t sig[2][50000];
+    size_t sig_sz = 0;
+
+    max = hash_cpu_probe();
+    for (level = max; level >= HASH_CPU_C; level--) {
+        hash_cpu_select(level);
+        slh_keygen(pk, sk, cpu_rbg, iut);
+        sig_sz = slh_sign(sig[level != max], m, 3, sk, cpu_rbg, iut);
+        if (!slh_verify(m, 3, sig[level != max], pk, iut) ||
+            memcmp(sig[0], sig[1], level != max ? sig_sz : 0) != 0) {
+            fail++;
+            fprintf(stderr, "[FAIL] %s kernels %s mismatch.\n",
+                    slh_alg_id(iut), hash_cpu_name());
+        }
+    }
+    hash_cpu_select(max);
+    printf("[INFO] %s kernels: %s\n", slh_alg_id(iut), hash_cpu_name());
+
+    return fail;
+}
+
+//  phase trace: count the events of each phase and check their nesting
+
+typedef struct {
+    uint32_t    n[8];                       //  completed phases
+    int         stack[8];                   //  open phases
+    int         depth;
+    uint64_t    t;                          //  last time stamp
+    int         err;
+} trace_log_t;
+
+static void trace_event(void *arg, int phase, uint32_t layer, bool end,
+                        uint64_t t)
+{
+    trace_log_t *tl = (trace_log_t *) arg;
+
+    (void) layer;
+    if (phase < 0 || phase >= 8 || t < tl->t) {
+        tl->err++;
+        return;
+    }
+    tl->t = t;
+    if (!end) {
+        if (tl->depth >= 8) {
+            tl->err++;
+            return;
+        }
+        tl->stack[tl->depth++] = phase;
+    } else {
+        if (tl->depth == 0 || tl->stack[tl->depth - 1] != phase) {
+            tl->err++;
+            return;
+        }
+        tl->depth--;
+        tl->n[phase]++;
+    }
+}
+
+//  signing and verification with key objects, and with slh_sign_trace()
+//  and slh_verify_trace(), report all of their phases
+
+int kat_trace_test(const slh_param_t *iut)
+{
+    int fail = 0;
+    const uint8_t m[3] = { 'a', 'b', 'c' };
+    uint8_t pk[2 * 32], sk[4 * 32];
+    static uint8_t sig[50000];
+    trace_log_t ts, tv;
+    slh_trace_t tr_s = { trace_event, &ts };
+    slh_trace_t tr_v = { trace_event, &tv };
+    slh_skey_t *skey;
+    slh_pkey_t *pkey;
+    uint32_t d = iut->d;
+
+    slh_keygen(pk, sk, cpu_rbg, iut);
+    skey = slh_skey_new(sk, iut, 0, NULL);
+    pkey = slh_pkey_new(pk, iut);
+    if (skey == NULL || pkey == NULL) {
+        fprintf(stderr, "[FAIL] %s trace key objects.\n", slh_alg_id(iut));
+        return 1;
+    }
+    slh_skey_trace(skey, &tr_s);
+    slh_pkey_trace(pkey, &tr_v);
+
+    //  first with the key objects, then with the plain functions
+    for (int i = 0; i < 2; i++) {
+        memset(&ts, 0, sizeof(ts));
+        memset(&tv, 0, sizeof(tv));
+        if (i == 0) {
+            slh_sign_skey(sig, m, 3, skey, cpu_rbg, NULL);
+            if (!slh_verify_pkey(m, 3, sig, pkey, NULL)) {
+                fail++;
+            }
+        } else {
+            slh_sign_trace(sig, m, 3, sk, cpu_rbg, iut, &tr_s);
+            if (!slh_verify_trace(m, 3, sig, pk, iut, &tr_v)) {
+                fail++;
+            }
+        }
+        if (ts.err != 0 || ts.depth != 0 ||
+            ts.n[SLH_TR_PRF_MSG] != 1 || ts.n[SLH_TR_H_MSG] != 1 ||
+            ts.n[SLH_TR_FORS_SIGN] != 1 || ts.n[SLH_TR_FORS_PK] != 1 ||
+            ts.n[SLH_TR_HT_SIGN] != 1 || ts.n[SLH_TR_XMSS_SIGN] != d ||
+            ts.n[SLH_TR_XMSS_PK] != d - 1 || ts.n[SLH_TR_HT_VERIFY] != 0) {
+            fail++;
+        }
+        if (tv.err != 0 || tv.depth != 0 ||
+            tv.n[SLH_TR_PRF_MSG] != 0 || tv.n[SLH_TR_H_MSG] != 1 ||
+            tv.n[SLH_TR_FORS_PK] != 1 || tv.n[SLH_TR_HT_VERIFY] != 1 ||
+            tv.n[SLH_TR_XMSS_PK] != d || tv.n[SLH_TR_XMSS_SIGN] != 0) {
+            fail++;
+        }
+    }
+
+    //  no events after the callback is removed
+    slh_pkey_trace(pkey, NULL);
+    slh_verify_pkey(m, 3, sig, pkey, NULL);
+    if (tv.n[SLH_TR_H_MSG] != 1) {
+        fail++;
+    }
+
+    if (fail > 0) {
+        fprintf(stderr, "[FAIL] %s phase trace.\n", slh_alg_id(iut));
+    }
+    slh_pkey_free(pkey);
+    slh_skey_free(skey);
+
+    return fail;
+}
+
+//  pure and pre-hash signatures are slh_sign() signatures of the messages
+//  M' of the final FIPS 205, typed in here byte by byte
+
+int kat_ctx_test(const slh_param_t *iut)
+{
+    int fail = 0;
+    const uint8_t m[3] = { 'a', 'b', 'c' };
+    const uint8_t ctx[3] = { 'c', 't', 'x' };
+    //  SHA-256("abc")
+    const uint8_t sha256_abc[32] = {
+        0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA,
+        0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+        0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C,
+        0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD };
+    //  DER encoding of OID 2.16.840.1.101.3.4.2.x without the last byte x
+    const uint8_t oid[10] = {
+        0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02 };
+    const uint8_t oid_x[4] = { 0x01, 0x03, 0x0B, 0x0C };
+    const size_t ph_l[4] = { 32, 64, 32, 64 };
+    uint8_t pk[2 * 32], sk[4 * 32], ph_m[64], mp[2 + 3 + 11 + 64];
+    static uint8_t sig[50000], sig2[50000];
+    size_t sig_sz = slh_sig_sz(iut);
+    int i, ph;
+
+    slh_keygen(pk, sk, cpu_rbg, iut);
+
+    //  pure: M' = 0x00 || 3 || "ctx" || "abc"
+    mp[0] = 0x00;
+    mp[1] = 3;
+    memcpy(mp + 2, ctx, 3);
+    memcpy(mp + 5, m, 3);
+    if (slh_pure_sign(sig, m, 3, ctx, 3, sk, cpu_rbg, iut) != sig_sz ||
+        slh_sign(sig2, mp, 8, sk, cpu_rbg, iut) != sig_sz ||
+        memcmp(sig, sig2, sig_sz) != 0 ||
+        !slh_pure_verify(m, 3, ctx, 3, sig, pk, iut) ||
+        slh_pure_verify(m, 3, ctx, 2, sig, pk, iut) ||
+        slh_verify(m, 3, sig, pk, iut)) {
+        fail++;
+        fprintf(stderr, "[FAIL] %s slh_pure_sign() M'.\n",
+                slh_alg_id(iut));
+    }
+
+    if (slh_ph_digest(ph_m, m, 3, SLH_PH_SHA2_256) != 32 ||
+        memcmp(ph_m, sha256_abc, 32) != 0) {
+        fail++;
+        fprintf(stderr, "[FAIL] slh_ph_digest() SHA-256.\n");
+    }
+
+    //  pre-hash: M' = 0x01 || 3 || "ctx" || OID || PH(M), with PH(M)
+    //  SHA-256("abc") and otherwise just some bytes of the right length
+    for (ph = SLH_PH_SHA2_256; ph <= SLH_PH_SHAKE256; ph++) {
+        for (i = 0; i < 64; i++) {
+            ph_m[i] = i < 32 ? sha256_abc[i] : (uint8_t) i;
+        }
+        mp[0] = 0x01;
+        mp[1] = 3;
+        memcpy(mp + 2, ctx, 3);
+        memcpy(mp + 5, oid, 10);
+        mp[15] = oid_x[ph - SLH_PH_SHA2_256];
+        memcpy(mp + 16, ph_m, ph_l[ph - SLH_PH_SHA2_256]);
+        if (slh_ph_sign(sig, ph_m, ph, ctx, 3, sk, cpu_rbg, iut) != sig_sz ||
+            slh_sign(sig2, mp, 16 + ph_l[ph - SLH_PH_SHA2_256], sk, cpu_rbg,
+                        iut) != sig_sz ||
+            memcmp(sig, sig2, sig_sz) != 0 ||
+            !slh_ph_verify(ph_m, ph, ctx, 3, sig, pk, iut)) {
+            fail++;
+            fprintf(stderr, "[FAIL] %s slh_ph_sign() M' ph= %d.\n",
+                    slh_alg_id(iut), ph);
+        }
+    }
+
+    return fail;
+}
+
+#ifdef SLH_COUNT
+
+//  check a hash invocation count
+
+static int count_chk(const slh_param_t *iut, const char *what,
+                        int op, int type, int layer, uint64_t x)
+{
+    uint64_t c = slh_count_get(op, type, layer);
+
+    if (c != x) {
+        fprintf(stderr, "[FAIL] %s count %s = %llu (expected %llu)\n",
+                slh_alg_id(iut), what,
+                (unsigned long long) c, (unsigned long long) x);
+        return 1;
+    }
+    return 0;
+}
+
+//  key generation and verification make a known number of hash calls
+
+int kat_count_test(const slh_param_t *iut)
+{
+    int fail = 0;
+    const uint8_t m[3] = { 'a', 'b', 'c' };
+    uint8_t pk[2 * 32], sk[4 * 32];
+    static uint8_t sig[50000];
+    uint32_t d = iut->d, k = iut->k, a = iut->a, hp = iut->hp;
+    uint64_t leaves = UINT64_C(1) << hp;
+    uint64_t len = 2 * iut->n + 3;          //  WOTS+ chains (lg_w = 4)
+    int comp;
+
+    //  F and PRF are computed with SHA-256 in all SHA2 parameter sets
+    comp = strstr(slh_alg_id(iut), "SHAKE") != NULL ?
+            SLH_CNT_KECCAK : SLH_CNT_SHA256;
+
+    //  the top XMSS tree
+    slh_count_reset();
+    slh_keygen(pk, sk, cpu_rbg, iut);
+    fail += count_chk(iut, "keygen PRF", SLH_CNT_PRF, -1, -1, leaves * len);
+    fail += count_chk(iut, "keygen WOTS_PRF", SLH_CNT_PRF,
+                        ADRS_WOTS_PRF, d - 1, leaves * len);
+    fail += count_chk(iut, "keygen F", SLH_CNT_F, -1, -1, leaves * len * 15);
+    fail += count_chk(iut, "keygen WOTS_HASH", SLH_CNT_F,
+                        ADRS_WOTS_HASH, d - 1, leaves * len * 15);
+    fail += count_chk(iut, "keygen T", SLH_CNT_T,
+                        ADRS_WOTS_PK, d - 1, leaves);
+    fail += count_chk(iut, "keygen H", SLH_CNT_H,
+                        ADRS_TREE, d - 1, leaves - 1);
+    fail += count_chk(iut, "keygen H_msg", SLH_CNT_H_MSG, -1, -1, 0);
+    if (slh_count_get(comp, -1, -1) < leaves * len * 16) {
+        fail++;
+        fprintf(stderr, "[FAIL] %s count keygen compressions\n",
+                slh_alg_id(iut));
+    }
+
+    //  signing: FORS secret values and the message hashes
+    slh_count_reset();
+    slh_sign(sig, m, 3, sk, cpu_rbg, iut);
+    fail += count_chk(iut, "sign FORS_PRF", SLH_CNT_PRF,
+                        ADRS_FORS_PRF, 0, k << a);
+    fail += count_chk(iut, "sign FORS_ROOTS", SLH_CNT_T,
+                        ADRS_FORS_ROOTS, 0, 1);
+    fail += count_chk(iut, "sign H_msg", SLH_CNT_H_MSG, -1, -1, 1);
+    fail += count_chk(iut, "sign PRF_msg", SLH_CNT_PRF_MSG, -1, -1, 1);
+
+    //  verification: one authentication path per FORS tree and layer
+    slh_count_reset();
+    if (!slh_verify(m, 3, sig, pk, iut)) {
+        fail++;
+        fprintf(stderr, "[FAIL] %s count verify\n", slh_alg_id(iut));
+    }
+    fail += count_chk(iut, "verify PRF", SLH_CNT_PRF, -1, -1, 0);
+    fail += count_chk(iut, "verify FORS F", SLH_CNT_F,
+                        ADRS_FORS_TREE, 0, k);
+    fail += count_chk(iut, "verify FORS H", SLH_CNT_H,
+                        ADRS_FORS_TREE, 0, k * a);
+    fail += count_chk(iut, "verify TREE H", SLH_CNT_H,
+                        ADRS_TREE, -1, d * hp);
+    fail += count_chk(iut, "verify WOTS_PK T", SLH_CNT_T,
+                        ADRS_WOTS_PK, -1, d);
+    fail += count_chk(iut, "verify T", SLH_CNT_T, -1, -1, d + 1);
+    fail += count_chk(iut, "verify H_msg", SLH_CNT_H_MSG, -1, -1, 1);
+
+    return fail;
+}
+
+//  SLH_COUNT
+#endif
+
 //  test targets
 
 const slh_param_t *test_iut[] = {
@@ -154,6 +667,13 @@ int main(int argc, char **argv)
     int fail = 0;
     int iut_n = 0;
 
+    iut_par = slh_pool_new(4);
+    iut_vc_in = slh_vcache_new(1024);
+    if (iut_vc_in != NULL) {
+        iut_vc_count.entries = iut_vc_in->entries;
+        iut_vc = &iut_vc_count;
+    }
+
     if  (argc == 2 &&
         (iut_n = atoi(argv[1])) >= 0 &&
         iut_n < 12) {
@@ -162,8 +682,22 @@ int main(int argc, char **argv)
         for (iut_n = 0; test_iut[iut_n] != NULL; iut_n++) {
             fail += kat_test(test_iut[iut_n], KATNUM);
         }
+        fail += kat_cpu_test(&slh_dsa_shake_128f);
+        fail += kat_cpu_test(&slh_dsa_sha2_192f);
+        fail += kat_trace_test(&slh_dsa_shake_128f);
+        fail += kat_trace_test(&slh_dsa_sha2_128s);
+        fail += kat_ctx_test(&slh_dsa_shake_128f);
+        fail += kat_ctx_test(&slh_dsa_sha2_128f);
+#ifdef SLH_COUNT
+        for (iut_n = 0; test_iut[iut_n] != NULL; iut_n++) {
+            fail += kat_count_test(test_iut[iut_n]);
+        }
+#endif
     }
 
+    slh_vcache_free(iut_vc_in);
+    slh_pool_free(iut_par);
+
     printf("[INFO] test_slh_dsa() fail= %d\n", fail);
 
     return fail;
@@ -5,6 +5,8 @@
 
 #include "sha2_api.h"
 #include "plat_local.h"
+#include "hash_cpu.h"
+#include "slh_count.h"
 #include <string.h>
 
 #ifndef SLOTH_SHA256
@@ -25,7 +27,7 @@
             (ror32(x1,  7) ^ ror32(x1, 18) ^ (x1 >>  3)) +  \
             (ror32(xe, 17) ^ ror32(xe, 19) ^ (xe >> 10));   }
 
-void sha256_compress(void *v)
+static void sha256_compress_c(void *v)
 {
     //  4.2.2 SHA-224 and SHA-256 Constants
 
@@ -134,6 +136,20 @@ void sha256_compress(void *v)
     sp[7] = rev8_be32(sp[7] + h);
 }
 
+//  compression function (runtime selection of the implementation)
+
+void sha256_compress(void *v)
+{
+    SLH_COUNT_OP(SLH_CNT_SHA256, 1);
+#ifdef SHA256_NI
+    if (hash_cpu.sha_ni) {
+        sha256_compress_ni(v);
+        return;
+    }
+#endif
+    sha256_compress_c(v);
+}
+
 #endif
 
 //  initialize
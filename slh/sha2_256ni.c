@@ -0,0 +1,89 @@
+//  sha2_256ni.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === SHA2-256 compression function with the x86 SHA extensions (SHA-NI.)
+
+#include "sha2_api.h"
+
+#if !defined(SLOTH_SHA256) && defined(SHA256_NI)
+
+#include <immintrin.h>
+
+//  Same interface as sha256_compress(): 8 state words followed by 16
+//  message words, all in memory (big-endian) byte order. The caller must
+//  check that the CPU supports the instructions.
+
+__attribute__((target("sha,sse4.1,ssse3")))
+void sha256_compress_ni(void *v)
+{
+    //  4.2.2 SHA-224 and SHA-256 Constants
+
+    static const uint32_t ck[64] __attribute__((aligned(16))) = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+        0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+        0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+        0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+        0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+        0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+        0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+        0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+        0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+    const __m128i bswap = _mm_set_epi8(
+        12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m128i *vp = (__m128i *) v;
+    __m128i s0, s1, t, abef, cdgh, w, m[4];
+    int i;
+
+    //  get state: (a, b, c, d), (e, f, g, h) -> (a, b, e, f), (c, d, g, h)
+    t   = _mm_shuffle_epi8(_mm_loadu_si128(&vp[0]), bswap);
+    s1  = _mm_shuffle_epi8(_mm_loadu_si128(&vp[1]), bswap);
+    t   = _mm_shuffle_epi32(t, 0xB1);
+    s1  = _mm_shuffle_epi32(s1, 0x1B);
+    s0  = _mm_alignr_epi8(t, s1, 8);
+    s1  = _mm_blend_epi16(s1, t, 0xF0);
+    abef = s0;
+    cdgh = s1;
+
+    //  load and reverse bytes
+    for (i = 0; i < 4; i++) {
+        m[i] = _mm_shuffle_epi8(_mm_loadu_si128(&vp[2 + i]), bswap);
+    }
+
+    //  16 x 4 rounds; m[] holds the last 16 words of the message schedule
+    for (i = 0; i < 16; i++) {
+        if (i >= 4) {
+            w = _mm_sha256msg1_epu32(m[i & 3], m[(i + 1) & 3]);
+            w = _mm_add_epi32(w,
+                    _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4));
+            m[i & 3] = _mm_sha256msg2_epu32(w, m[(i + 3) & 3]);
+        }
+        w  = _mm_add_epi32(m[i & 3],
+                            _mm_load_si128((const __m128i *) &ck[4 * i]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, w);
+        w  = _mm_shuffle_epi32(w, 0x0E);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, w);
+    }
+
+    //  add and put back: (a, b, e, f), (c, d, g, h) -> (a, b, c, d), ..
+    s0  = _mm_add_epi32(s0, abef);
+    s1  = _mm_add_epi32(s1, cdgh);
+    t   = _mm_shuffle_epi32(s0, 0x1B);
+    s1  = _mm_shuffle_epi32(s1, 0xB1);
+    s0  = _mm_blend_epi16(t, s1, 0xF0);
+    s1  = _mm_alignr_epi8(s1, t, 8);
+    _mm_storeu_si128(&vp[0], _mm_shuffle_epi8(s0, bswap));
+    _mm_storeu_si128(&vp[1], _mm_shuffle_epi8(s1, bswap));
+}
+
+//  !SLOTH_SHA256 && SHA256_NI
+#endif
@@ -0,0 +1,255 @@
+//  sha2_256x.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Multi-buffer SHA2-256 compression functions (8 and 16 lanes.)
+
+#ifndef SLOTH_SHA256
+
+#include "sha2_api.h"
+#include "plat_local.h"
+#include "hash_cpu.h"
+#include "slh_count.h"
+
+//  The state layout matches sha256_compress(): 8 state words followed by
+//  16 message words in memory (big-endian) byte order, but interleaved so
+//  that word i of lane j is at uint32_t v[i][j]. Messages are not modified.
+//  The SIMD kernels are selected at runtime; see hash_cpu.c.
+
+#ifdef HASH_CPU_X86
+#include <immintrin.h>
+
+//  4.2.2 SHA-224 and SHA-256 Constants
+
+static const uint32_t sha256x_k[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+//  generic vector round macros; need ADD, XOR, AND, OR, ROR, SHR, SET1
+
+#define STEP_SHA256X_R(a, b, c, d, e, f, g, h, mi, ki) {            \
+    h = ADD(ADD(h, XOR(g, AND(e, XOR(f, g)))), ADD(mi, SET1(ki)));  \
+    h = ADD(h, XOR(XOR(ROR(e, 6), ROR(e, 11)), ROR(e, 25)));        \
+    d = ADD(d, h);                                                  \
+    h = ADD(h, OR(AND(OR(a, c), b), AND(c, a)));                    \
+    h = ADD(h, XOR(XOR(ROR(a, 2), ROR(a, 13)), ROR(a, 22)));        }
+
+#define STEP_SHA256X_K(x0, x1, x9, xe) {                            \
+    x0 = ADD(ADD(x0, x9),                                           \
+            XOR(XOR(ROR(x1,  7), ROR(x1, 18)), SHR(x1,  3)));       \
+    x0 = ADD(x0, XOR(XOR(ROR(xe, 17), ROR(xe, 19)), SHR(xe, 10)));  }
+
+//  the compression function body, for a vector type "vec_t"
+
+#define SHA256X_BODY(vec_t, v) {                                    \
+    int r;                                                          \
+    vec_t a, b, c, d, e, f, g, h, s[8], m[16];                      \
+    vec_t *vp = (vec_t *) (v);                                      \
+    for (r = 0; r < 8; r++) {                                       \
+        s[r] = BSWAP(LOAD(&vp[r]));                                 \
+    }                                                               \
+    for (r = 0; r < 16; r++) {                                      \
+        m[r] = BSWAP(LOAD(&vp[8 + r]));                             \
+    }                                                               \
+    a = s[0]; b = s[1]; c = s[2]; d = s[3];                         \
+    e = s[4]; f = s[5]; g = s[6]; h = s[7];                         \
+    for (r = 0; r < 64; r += 16) {                                  \
+        if (r > 0) {                                                \
+            STEP_SHA256X_K(m[ 0], m[ 1], m[ 9], m[14]);             \
+            STEP_SHA256X_K(m[ 1], m[ 2], m[10], m[15]);             \
+            STEP_SHA256X_K(m[ 2], m[ 3], m[11], m[ 0]);             \
+            STEP_SHA256X_K(m[ 3], m[ 4], m[12], m[ 1]);             \
+            STEP_SHA256X_K(m[ 4], m[ 5], m[13], m[ 2]);             \
+            STEP_SHA256X_K(m[ 5], m[ 6], m[14], m[ 3]);             \
+            STEP_SHA256X_K(m[ 6], m[ 7], m[15], m[ 4]);             \
+            STEP_SHA256X_K(m[ 7], m[ 8], m[ 0], m[ 5]);             \
+            STEP_SHA256X_K(m[ 8], m[ 9], m[ 1], m[ 6]);             \
+            STEP_SHA256X_K(m[ 9], m[10], m[ 2], m[ 7]);             \
+            STEP_SHA256X_K(m[10], m[11], m[ 3], m[ 8]);             \
+            STEP_SHA256X_K(m[11], m[12], m[ 4], m[ 9]);             \
+            STEP_SHA256X_K(m[12], m[13], m[ 5], m[10]);             \
+            STEP_SHA256X_K(m[13], m[14], m[ 6], m[11]);             \
+            STEP_SHA256X_K(m[14], m[15], m[ 7], m[12]);             \
+            STEP_SHA256X_K(m[15], m[ 0], m[ 8], m[13]);             \
+        }                                                           \
+        STEP_SHA256X_R(a, b, c, d, e, f, g, h, m[ 0], sha256x_k[r + 0]);  \
+        STEP_SHA256X_R(h, a, b, c, d, e, f, g, m[ 1], sha256x_k[r + 1]);  \
+        STEP_SHA256X_R(g, h, a, b, c, d, e, f, m[ 2], sha256x_k[r + 2]);  \
+        STEP_SHA256X_R(f, g, h, a, b, c, d, e, m[ 3], sha256x_k[r + 3]);  \
+        STEP_SHA256X_R(e, f, g, h, a, b, c, d, m[ 4], sha256x_k[r + 4]);  \
+        STEP_SHA256X_R(d, e, f, g, h, a, b, c, m[ 5], sha256x_k[r + 5]);  \
+        STEP_SHA256X_R(c, d, e, f, g, h, a, b, m[ 6], sha256x_k[r + 6]);  \
+        STEP_SHA256X_R(b, c, d, e, f, g, h, a, m[ 7], sha256x_k[r + 7]);  \
+        STEP_SHA256X_R(a, b, c, d, e, f, g, h, m[ 8], sha256x_k[r + 8]);  \
+        STEP_SHA256X_R(h, a, b, c, d, e, f, g, m[ 9], sha256x_k[r + 9]);  \
+        STEP_SHA256X_R(g, h, a, b, c, d, e, f, m[10], sha256x_k[r + 10]); \
+        STEP_SHA256X_R(f, g, h, a, b, c, d, e, m[11], sha256x_k[r + 11]); \
+        STEP_SHA256X_R(e, f, g, h, a, b, c, d, m[12], sha256x_k[r + 12]); \
+        STEP_SHA256X_R(d, e, f, g, h, a, b, c, m[13], sha256x_k[r + 13]); \
+        STEP_SHA256X_R(c, d, e, f, g, h, a, b, m[14], sha256x_k[r + 14]); \
+        STEP_SHA256X_R(b, c, d, e, f, g, h, a, m[15], sha256x_k[r + 15]); \
+    }                                                               \
+    STORE(&vp[0], BSWAP(ADD(s[0], a)));                             \
+    STORE(&vp[1], BSWAP(ADD(s[1], b)));                             \
+    STORE(&vp[2], BSWAP(ADD(s[2], c)));                             \
+    STORE(&vp[3], BSWAP(ADD(s[3], d)));                             \
+    STORE(&vp[4], BSWAP(ADD(s[4], e)));                             \
+    STORE(&vp[5], BSWAP(ADD(s[5], f)));                             \
+    STORE(&vp[6], BSWAP(ADD(s[6], g)));                             \
+    STORE(&vp[7], BSWAP(ADD(s[7], h)));                             }
+
+//  === 8 lanes
+
+#define LOAD(p)     _mm256_loadu_si256(p)
+#define STORE(p, x) _mm256_storeu_si256(p, x)
+#define ADD(x, y)   _mm256_add_epi32(x, y)
+#define XOR(x, y)   _mm256_xor_si256(x, y)
+#define AND(x, y)   _mm256_and_si256(x, y)
+#define OR(x, y)    _mm256_or_si256(x, y)
+#define SHR(x, r)   _mm256_srli_epi32(x, r)
+#define ROR(x, r)   _mm256_or_si256(_mm256_srli_epi32(x, r),\
+                                    _mm256_slli_epi32(x, 32 - (r)))
+#define SET1(k)     _mm256_set1_epi32(k)
+#define BSWAP(x)    _mm256_shuffle_epi8(x, bswap8)
+
+__attribute__((target("avx2")))
+static void sha256_compress_x8_avx2(void *v)
+{
+    const __m256i bswap8 = _mm256_set_epi8(
+        12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7,  0,  1,  2,  3,
+        12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7,  0,  1,  2,  3);
+
+    SHA256X_BODY(__m256i, v)
+}
+
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef XOR
+#undef AND
+#undef OR
+#undef SHR
+#undef ROR
+#undef SET1
+#undef BSWAP
+
+//  === 16 lanes
+
+#define LOAD(p)     _mm512_loadu_si512(p)
+#define STORE(p, x) _mm512_storeu_si512(p, x)
+#define ADD(x, y)   _mm512_add_epi32(x, y)
+#define XOR(x, y)   _mm512_xor_si512(x, y)
+#define AND(x, y)   _mm512_and_si512(x, y)
+#define OR(x, y)    _mm512_or_si512(x, y)
+#define SHR(x, r)   _mm512_srli_epi32(x, r)
+#define ROR(x, r)   _mm512_ror_epi32(x, r)
+#define SET1(k)     _mm512_set1_epi32(k)
+#define BSWAP(x)    _mm512_shuffle_epi8(x, bswap16)
+
+__attribute__((target("avx512f,avx512bw")))
+static void sha256_compress_x16_avx512(void *v)
+{
+    const __m512i bswap16 = _mm512_broadcast_i32x4(_mm_set_epi8(
+        12, 13, 14, 15,  8,  9, 10, 11,  4,  5,  6,  7,  0,  1,  2,  3));
+
+    SHA256X_BODY(__m512i, v)
+}
+
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef XOR
+#undef AND
+#undef OR
+#undef SHR
+#undef ROR
+#undef SET1
+#undef BSWAP
+
+//  HASH_CPU_X86
+#endif
+
+//  portable fallback
+
+static void sha256_compress_x8_c(void *v)
+{
+    uint32_t (*vp)[8] = (uint32_t (*)[8]) v;
+    uint32_t x[24];
+    int i, j;
+
+    for (j = 0; j < 8; j++) {
+        for (i = 0; i < 24; i++) {
+            x[i] = vp[i][j];
+        }
+        sha256_compress(x);
+        for (i = 0; i < 8; i++) {
+            vp[i][j] = x[i];
+        }
+    }
+}
+
+//  runtime selection of the implementation
+
+void sha256_compress_x8(void *v)
+{
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX2) {
+        SLH_COUNT_OP(SLH_CNT_SHA256, 8);
+        sha256_compress_x8_avx2(v);
+        return;
+    }
+#endif
+    sha256_compress_x8_c(v);
+}
+
+//  fallback: two 8-lane halves
+
+static void sha256_compress_x16_c(void *v)
+{
+    uint32_t (*vp)[16] = (uint32_t (*)[16]) v;
+    uint32_t x[24][8];
+    int i, j, k;
+
+    for (k = 0; k < 16; k += 8) {
+        for (i = 0; i < 24; i++) {
+            for (j = 0; j < 8; j++) {
+                x[i][j] = vp[i][k + j];
+            }
+        }
+        sha256_compress_x8(x);
+        for (i = 0; i < 8; i++) {
+            for (j = 0; j < 8; j++) {
+                vp[i][k + j] = x[i][j];
+            }
+        }
+    }
+}
+
+void sha256_compress_x16(void *v)
+{
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX512) {
+        SLH_COUNT_OP(SLH_CNT_SHA256, 16);
+        sha256_compress_x16_avx512(v);
+        return;
+    }
+#endif
+    sha256_compress_x16_c(v);
+}
+
+//  SLOTH_SHA256
+#endif
@@ -5,6 +5,7 @@
 
 #include "sha2_api.h"
 #include "plat_local.h"
+#include "slh_count.h"
 #include <string.h>
 
 #ifndef SLOTH_SHA512
@@ -29,6 +30,8 @@
 
 void sha512_compress(void *v)
 {
+    SLH_COUNT_OP(SLH_CNT_SHA512, 1);
+
     //  4.2.3 SHA-384, SHA-512, SHA-512/224 and SHA-512/256 Constants
 
     const uint64_t ck[80] = {
@@ -0,0 +1,279 @@
+//  sha2_512x.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Multi-buffer SHA2-512 compression functions (4 and 8 lanes.)
+
+#ifndef SLOTH_SHA512
+
+#include "sha2_api.h"
+#include "plat_local.h"
+#include "hash_cpu.h"
+#include "slh_count.h"
+
+//  The state layout matches sha512_compress(): 8 state words followed by
+//  16 message words in memory (big-endian) byte order, but interleaved so
+//  that word i of lane j is at uint64_t v[i][j]. Messages are not modified.
+//  The SIMD kernels are selected at runtime; see hash_cpu.c.
+
+#ifdef HASH_CPU_X86
+#include <immintrin.h>
+
+//  4.2.3 SHA-384, SHA-512, SHA-512/224 and SHA-512/256 Constants
+
+static const uint64_t sha512x_k[80] = {
+    UINT64_C(0x428A2F98D728AE22),   UINT64_C(0x7137449123EF65CD),
+    UINT64_C(0xB5C0FBCFEC4D3B2F),   UINT64_C(0xE9B5DBA58189DBBC),
+    UINT64_C(0x3956C25BF348B538),   UINT64_C(0x59F111F1B605D019),
+    UINT64_C(0x923F82A4AF194F9B),   UINT64_C(0xAB1C5ED5DA6D8118),
+    UINT64_C(0xD807AA98A3030242),   UINT64_C(0x12835B0145706FBE),
+    UINT64_C(0x243185BE4EE4B28C),   UINT64_C(0x550C7DC3D5FFB4E2),
+    UINT64_C(0x72BE5D74F27B896F),   UINT64_C(0x80DEB1FE3B1696B1),
+    UINT64_C(0x9BDC06A725C71235),   UINT64_C(0xC19BF174CF692694),
+    UINT64_C(0xE49B69C19EF14AD2),   UINT64_C(0xEFBE4786384F25E3),
+    UINT64_C(0x0FC19DC68B8CD5B5),   UINT64_C(0x240CA1CC77AC9C65),
+    UINT64_C(0x2DE92C6F592B0275),   UINT64_C(0x4A7484AA6EA6E483),
+    UINT64_C(0x5CB0A9DCBD41FBD4),   UINT64_C(0x76F988DA831153B5),
+    UINT64_C(0x983E5152EE66DFAB),   UINT64_C(0xA831C66D2DB43210),
+    UINT64_C(0xB00327C898FB213F),   UINT64_C(0xBF597FC7BEEF0EE4),
+    UINT64_C(0xC6E00BF33DA88FC2),   UINT64_C(0xD5A79147930AA725),
+    UINT64_C(0x06CA6351E003826F),   UINT64_C(0x142929670A0E6E70),
+    UINT64_C(0x27B70A8546D22FFC),   UINT64_C(0x2E1B21385C26C926),
+    UINT64_C(0x4D2C6DFC5AC42AED),   UINT64_C(0x53380D139D95B3DF),
+    UINT64_C(0x650A73548BAF63DE),   UINT64_C(0x766A0ABB3C77B2A8),
+    UINT64_C(0x81C2C92E47EDAEE6),   UINT64_C(0x92722C851482353B),
+    UINT64_C(0xA2BFE8A14CF10364),   UINT64_C(0xA81A664BBC423001),
+    UINT64_C(0xC24B8B70D0F89791),   UINT64_C(0xC76C51A30654BE30),
+    UINT64_C(0xD192E819D6EF5218),   UINT64_C(0xD69906245565A910),
+    UINT64_C(0xF40E35855771202A),   UINT64_C(0x106AA07032BBD1B8),
+    UINT64_C(0x19A4C116B8D2D0C8),   UINT64_C(0x1E376C085141AB53),
+    UINT64_C(0x2748774CDF8EEB99),   UINT64_C(0x34B0BCB5E19B48A8),
+    UINT64_C(0x391C0CB3C5C95A63),   UINT64_C(0x4ED8AA4AE3418ACB),
+    UINT64_C(0x5B9CCA4F7763E373),   UINT64_C(0x682E6FF3D6B2B8A3),
+    UINT64_C(0x748F82EE5DEFB2FC),   UINT64_C(0x78A5636F43172F60),
+    UINT64_C(0x84C87814A1F0AB72),   UINT64_C(0x8CC702081A6439EC),
+    UINT64_C(0x90BEFFFA23631E28),   UINT64_C(0xA4506CEBDE82BDE9),
+    UINT64_C(0xBEF9A3F7B2C67915),   UINT64_C(0xC67178F2E372532B),
+    UINT64_C(0xCA273ECEEA26619C),   UINT64_C(0xD186B8C721C0C207),
+    UINT64_C(0xEADA7DD6CDE0EB1E),   UINT64_C(0xF57D4F7FEE6ED178),
+    UINT64_C(0x06F067AA72176FBA),   UINT64_C(0x0A637DC5A2C898A6),
+    UINT64_C(0x113F9804BEF90DAE),   UINT64_C(0x1B710B35131C471B),
+    UINT64_C(0x28DB77F523047D84),   UINT64_C(0x32CAAB7B40C72493),
+    UINT64_C(0x3C9EBE0A15C9BEBC),   UINT64_C(0x431D67C49C100D4C),
+    UINT64_C(0x4CC5D4BECB3E42B6),   UINT64_C(0x597F299CFC657E2A),
+    UINT64_C(0x5FCB6FAB3AD6FAEC),   UINT64_C(0x6C44198C4A475817)
+};
+
+//  generic vector round macros; need ADD, XOR, AND, OR, ROR, SHR, SET1
+
+#define STEP_SHA512X_R(a, b, c, d, e, f, g, h, mi, ki) {            \
+    h = ADD(ADD(h, XOR(g, AND(e, XOR(f, g)))), ADD(mi, SET1(ki)));  \
+    h = ADD(h, XOR(XOR(ROR(e, 14), ROR(e, 18)), ROR(e, 41)));       \
+    d = ADD(d, h);                                                  \
+    h = ADD(h, OR(AND(OR(a, c), b), AND(c, a)));                    \
+    h = ADD(h, XOR(XOR(ROR(a, 28), ROR(a, 34)), ROR(a, 39)));       }
+
+#define STEP_SHA512X_K(x0, x1, x9, xe) {                            \
+    x0 = ADD(ADD(x0, x9),                                           \
+            XOR(XOR(ROR(x1,  1), ROR(x1,  8)), SHR(x1,  7)));       \
+    x0 = ADD(x0, XOR(XOR(ROR(xe, 19), ROR(xe, 61)), SHR(xe,  6)));  }
+
+//  the compression function body, for a vector type "vec_t"
+
+#define SHA512X_BODY(vec_t, v) {                                    \
+    int r;                                                          \
+    vec_t a, b, c, d, e, f, g, h, s[8], m[16];                      \
+    vec_t *vp = (vec_t *) (v);                                      \
+    for (r = 0; r < 8; r++) {                                       \
+        s[r] = BSWAP(LOAD(&vp[r]));                                 \
+    }                                                               \
+    for (r = 0; r < 16; r++) {                                      \
+        m[r] = BSWAP(LOAD(&vp[8 + r]));                             \
+    }                                                               \
+    a = s[0]; b = s[1]; c = s[2]; d = s[3];                         \
+    e = s[4]; f = s[5]; g = s[6]; h = s[7];                         \
+    for (r = 0; r < 80; r += 16) {                                  \
+        if (r > 0) {                                                \
+            STEP_SHA512X_K(m[ 0], m[ 1], m[ 9], m[14]);             \
+            STEP_SHA512X_K(m[ 1], m[ 2], m[10], m[15]);             \
+            STEP_SHA512X_K(m[ 2], m[ 3], m[11], m[ 0]);             \
+            STEP_SHA512X_K(m[ 3], m[ 4], m[12], m[ 1]);             \
+            STEP_SHA512X_K(m[ 4], m[ 5], m[13], m[ 2]);             \
+            STEP_SHA512X_K(m[ 5], m[ 6], m[14], m[ 3]);             \
+            STEP_SHA512X_K(m[ 6], m[ 7], m[15], m[ 4]);             \
+            STEP_SHA512X_K(m[ 7], m[ 8], m[ 0], m[ 5]);             \
+            STEP_SHA512X_K(m[ 8], m[ 9], m[ 1], m[ 6]);             \
+            STEP_SHA512X_K(m[ 9], m[10], m[ 2], m[ 7]);             \
+            STEP_SHA512X_K(m[10], m[11], m[ 3], m[ 8]);             \
+            STEP_SHA512X_K(m[11], m[12], m[ 4], m[ 9]);             \
+            STEP_SHA512X_K(m[12], m[13], m[ 5], m[10]);             \
+            STEP_SHA512X_K(m[13], m[14], m[ 6], m[11]);             \
+            STEP_SHA512X_K(m[14], m[15], m[ 7], m[12]);             \
+            STEP_SHA512X_K(m[15], m[ 0], m[ 8], m[13]);             \
+        }                                                           \
+        STEP_SHA512X_R(a, b, c, d, e, f, g, h, m[ 0], sha512x_k[r + 0]);  \
+        STEP_SHA512X_R(h, a, b, c, d, e, f, g, m[ 1], sha512x_k[r + 1]);  \
+        STEP_SHA512X_R(g, h, a, b, c, d, e, f, m[ 2], sha512x_k[r + 2]);  \
+        STEP_SHA512X_R(f, g, h, a, b, c, d, e, m[ 3], sha512x_k[r + 3]);  \
+        STEP_SHA512X_R(e, f, g, h, a, b, c, d, m[ 4], sha512x_k[r + 4]);  \
+        STEP_SHA512X_R(d, e, f, g, h, a, b, c, m[ 5], sha512x_k[r + 5]);  \
+        STEP_SHA512X_R(c, d, e, f, g, h, a, b, m[ 6], sha512x_k[r + 6]);  \
+        STEP_SHA512X_R(b, c, d, e, f, g, h, a, m[ 7], sha512x_k[r + 7]);  \
+        STEP_SHA512X_R(a, b, c, d, e, f, g, h, m[ 8], sha512x_k[r + 8]);  \
+        STEP_SHA512X_R(h, a, b, c, d, e, f, g, m[ 9], sha512x_k[r + 9]);  \
+        STEP_SHA512X_R(g, h, a, b, c, d, e, f, m[10], sha512x_k[r + 10]); \
+        STEP_SHA512X_R(f, g, h, a, b, c, d, e, m[11], sha512x_k[r + 11]); \
+        STEP_SHA512X_R(e, f, g, h, a, b, c, d, m[12], sha512x_k[r + 12]); \
+        STEP_SHA512X_R(d, e, f, g, h, a, b, c, m[13], sha512x_k[r + 13]); \
+        STEP_SHA512X_R(c, d, e, f, g, h, a, b, m[14], sha512x_k[r + 14]); \
+        STEP_SHA512X_R(b, c, d, e, f, g, h, a, m[15], sha512x_k[r + 15]); \
+    }                                                               \
+    STORE(&vp[0], BSWAP(ADD(s[0], a)));                             \
+    STORE(&vp[1], BSWAP(ADD(s[1], b)));                             \
+    STORE(&vp[2], BSWAP(ADD(s[2], c)));                             \
+    STORE(&vp[3], BSWAP(ADD(s[3], d)));                             \
+    STORE(&vp[4], BSWAP(ADD(s[4], e)));                             \
+    STORE(&vp[5], BSWAP(ADD(s[5], f)));                             \
+    STORE(&vp[6], BSWAP(ADD(s[6], g)));                             \
+    STORE(&vp[7], BSWAP(ADD(s[7], h)));                             }
+
+//  === 4 lanes
+
+#define LOAD(p)     _mm256_loadu_si256(p)
+#define STORE(p, x) _mm256_storeu_si256(p, x)
+#define ADD(x, y)   _mm256_add_epi64(x, y)
+#define XOR(x, y)   _mm256_xor_si256(x, y)
+#define AND(x, y)   _mm256_and_si256(x, y)
+#define OR(x, y)    _mm256_or_si256(x, y)
+#define SHR(x, r)   _mm256_srli_epi64(x, r)
+#define ROR(x, r)   _mm256_or_si256(_mm256_srli_epi64(x, r),\
+                                    _mm256_slli_epi64(x, 64 - (r)))
+#define SET1(k)     _mm256_set1_epi64x(k)
+#define BSWAP(x)    _mm256_shuffle_epi8(x, bswap4)
+
+__attribute__((target("avx2")))
+static void sha512_compress_x4_avx2(void *v)
+{
+    const __m256i bswap4 = _mm256_set_epi8(
+         8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7,
+         8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7);
+
+    SHA512X_BODY(__m256i, v)
+}
+
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef XOR
+#undef AND
+#undef OR
+#undef SHR
+#undef ROR
+#undef SET1
+#undef BSWAP
+
+//  === 8 lanes
+
+#define LOAD(p)     _mm512_loadu_si512(p)
+#define STORE(p, x) _mm512_storeu_si512(p, x)
+#define ADD(x, y)   _mm512_add_epi64(x, y)
+#define XOR(x, y)   _mm512_xor_si512(x, y)
+#define AND(x, y)   _mm512_and_si512(x, y)
+#define OR(x, y)    _mm512_or_si512(x, y)
+#define SHR(x, r)   _mm512_srli_epi64(x, r)
+#define ROR(x, r)   _mm512_ror_epi64(x, r)
+#define SET1(k)     _mm512_set1_epi64(k)
+#define BSWAP(x)    _mm512_shuffle_epi8(x, bswap8)
+
+__attribute__((target("avx512f,avx512bw")))
+static void sha512_compress_x8_avx512(void *v)
+{
+    const __m512i bswap8 = _mm512_broadcast_i32x4(_mm_set_epi8(
+         8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7));
+
+    SHA512X_BODY(__m512i, v)
+}
+
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef XOR
+#undef AND
+#undef OR
+#undef SHR
+#undef ROR
+#undef SET1
+#undef BSWAP
+
+//  HASH_CPU_X86
+#endif
+
+//  portable fallback
+
+static void sha512_compress_x4_c(void *v)
+{
+    uint64_t (*vp)[4] = (uint64_t (*)[4]) v;
+    uint64_t x[24];
+    int i, j;
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < 24; i++) {
+            x[i] = vp[i][j];
+        }
+        sha512_compress(x);
+        for (i = 0; i < 8; i++) {
+            vp[i][j] = x[i];
+        }
+    }
+}
+
+//  runtime selection of the implementation
+
+void sha512_compress_x4(void *v)
+{
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX2) {
+        SLH_COUNT_OP(SLH_CNT_SHA512, 4);
+        sha512_compress_x4_avx2(v);
+        return;
+    }
+#endif
+    sha512_compress_x4_c(v);
+}
+
+//  fallback: two 4-lane halves
+
+static void sha512_compress_x8_c(void *v)
+{
+    uint64_t (*vp)[8] = (uint64_t (*)[8]) v;
+    uint64_t x[24][4];
+    int i, j, k;
+
+    for (k = 0; k < 8; k += 4) {
+        for (i = 0; i < 24; i++) {
+            for (j = 0; j < 4; j++) {
+                x[i][j] = vp[i][k + j];
+            }
+        }
+        sha512_compress_x4(x);
+        for (i = 0; i < 8; i++) {
+            for (j = 0; j < 4; j++) {
+                vp[i][k + j] = x[i][j];
+            }
+        }
+    }
+}
+
+void sha512_compress_x8(void *v)
+{
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX512) {
+        SLH_COUNT_OP(SLH_CNT_SHA512, 8);
+        sha512_compress_x8_avx512(v);
+        return;
+    }
+#endif
+    sha512_compress_x8_c(v);
+}
+
+//  SLOTH_SHA512
+#endif
@@ -75,6 +75,18 @@ void sha512_copy(sha512_t *dst, const sha512_t *src);
 void sha256_compress(void *v);
 void sha512_compress(void *v);
 
+//  multi-buffer compression functions; word i of lane j at v[i][j]
+void sha256_compress_x8(void *v);
+void sha256_compress_x16(void *v);
+void sha512_compress_x4(void *v);
+void sha512_compress_x8(void *v);
+
+//  x86 SHA extensions; sha256_compress() uses this if the CPU has them
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SHA256_NI
+void sha256_compress_ni(void *v);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
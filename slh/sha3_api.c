@@ -6,9 +6,11 @@
 
 #ifndef SLOTH_NO_SHA3
 #include "sha3_api.h"
+#include "plat_local.h"
 
 //  These functions have not been optimized for performance -- they are
 //  here just to facilitate testing of the permutation code implementations.
+//  (Only full input blocks are absorbed a word at a time, for long messages.)
 
 //  initialize the context for SHA3
 
@@ -27,12 +29,22 @@ void sha3_init(sha3_ctx_t *c, int mdlen)
 
 void sha3_update(sha3_ctx_t *c, const void *data, size_t len)
 {
+    const uint8_t *p = (const uint8_t *) data;
     size_t i;
-    int j;
+    int j, k;
 
     j = c->pt;
-    for (i = 0; i < len; i++) {
-        c->st.b[j++] ^= ((const uint8_t *) data)[i];
+    i = 0;
+    while (i < len) {
+        if (j == 0 && len - i >= (size_t) c->rsiz) {
+            for (k = 0; k < c->rsiz / 8; k++) {
+                c->st.d[k] ^= get64u_le(p + i + 8 * k);
+            }
+            keccak_f1600(c->st.d);
+            i += c->rsiz;
+            continue;
+        }
+        c->st.b[j++] ^= p[i++];
         if (j >= c->rsiz) {
             keccak_f1600(c->st.d);
             j = 0;
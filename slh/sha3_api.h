@@ -40,6 +40,9 @@ void shake_out(sha3_ctx_t *c, uint8_t *out, size_t lem);
 //  core permutation
 void keccak_f1600(void *st);
 
+//  four parallel permutations; word i of state j is at uint64_t st[i][j]
+void keccak_f1600_x4(void *st);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,10 +6,13 @@
 #ifndef SLOTH_KECCAK
 
 #include "plat_local.h"
+#include "hash_cpu.h"
+#include "slh_count.h"
 
 //  forward permutation
 
-void keccak_f1600(void *st)
+__attribute__((always_inline))
+static inline void keccak_f1600_body(void *st)
 {
     //  round constants
     static const uint64_t keccak_rc[24] = {
@@ -147,5 +150,29 @@ void keccak_f1600(void *st)
     }
 }
 
+//  with BMI1/2, the compiler uses the ANDN and RORX instructions
+
+#ifdef HASH_CPU_X86
+__attribute__((target("bmi,bmi2")))
+static void keccak_f1600_bmi(void *st)
+{
+    keccak_f1600_body(st);
+}
+#endif
+
+//  runtime selection of the implementation
+
+void keccak_f1600(void *st)
+{
+    SLH_COUNT_OP(SLH_CNT_KECCAK, 1);
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX2) {
+        keccak_f1600_bmi(st);
+        return;
+    }
+#endif
+    keccak_f1600_body(st);
+}
+
 //  SLOTH_KECCAK
 #endif
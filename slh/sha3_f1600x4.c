@@ -0,0 +1,233 @@
+//  sha3_f1600x4.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Four parallel FIPS 202 Keccak permutations (multi-buffer.)
+
+#ifndef SLOTH_KECCAK
+
+#include "plat_local.h"
+#include "sha3_api.h"
+#include "hash_cpu.h"
+#include "slh_count.h"
+
+#ifdef HASH_CPU_X86
+
+//  === AVX2: one 256-bit register holds the same word of all four states.
+
+#include <immintrin.h>
+
+#define XOR(a, b)   _mm256_xor_si256(a, b)
+#define ANDN(a, b)  _mm256_andnot_si256(a, b)
+#define ROR(a, r)   _mm256_or_si256(_mm256_srli_epi64(a, r),\
+                                    _mm256_slli_epi64(a, 64 - (r)))
+
+//  the body is compiled separately for AVX2 and AVX-512VL; with the latter
+//  the compiler uses the native rotate and ternary logic instructions
+
+__attribute__((target("avx2"), always_inline))
+static inline void keccak_f1600_x4_body(void *st)
+{
+    //  round constants
+    static const uint64_t keccak_rc[24] = {
+        UINT64_C(0x0000000000000001), UINT64_C(0x0000000000008082),
+        UINT64_C(0x800000000000808A), UINT64_C(0x8000000080008000),
+        UINT64_C(0x000000000000808B), UINT64_C(0x0000000080000001),
+        UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008009),
+        UINT64_C(0x000000000000008A), UINT64_C(0x0000000000000088),
+        UINT64_C(0x0000000080008009), UINT64_C(0x000000008000000A),
+        UINT64_C(0x000000008000808B), UINT64_C(0x800000000000008B),
+        UINT64_C(0x8000000000008089), UINT64_C(0x8000000000008003),
+        UINT64_C(0x8000000000008002), UINT64_C(0x8000000000000080),
+        UINT64_C(0x000000000000800A), UINT64_C(0x800000008000000A),
+        UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008080),
+        UINT64_C(0x0000000080000001), UINT64_C(0x8000000080008008)
+    };
+
+    int i;
+    __m256i *v = (__m256i *) st;
+    __m256i x[25];
+    __m256i t, y0, y1, y2, y3, y4;
+
+    for (i = 0; i < 25; i++) {
+        x[i] = _mm256_loadu_si256(&v[i]);
+    }
+
+    //  iteration (same structure as the scalar keccak_f1600())
+
+    for (i = 0; i < 24; i++) {
+
+        //  Theta
+
+        y4 = XOR(XOR(XOR(x[ 4], x[ 9]), XOR(x[14], x[19])), x[24]);
+        y1 = XOR(XOR(XOR(x[ 1], x[ 6]), XOR(x[11], x[16])), x[21]);
+        y3 = XOR(XOR(XOR(x[ 3], x[ 8]), XOR(x[13], x[18])), x[23]);
+        y0 = XOR(XOR(XOR(x[ 0], x[ 5]), XOR(x[10], x[15])), x[20]);
+        y2 = XOR(XOR(XOR(x[ 2], x[ 7]), XOR(x[12], x[17])), x[22]);
+
+        t  = ROR(y4, 63);
+        y4 = XOR(y4, ROR(y1, 63));
+        y1 = XOR(y1, ROR(y3, 63));
+        y3 = XOR(y3, ROR(y0, 63));
+        y0 = XOR(y0, ROR(y2, 63));
+        y2 = XOR(y2, t);
+
+        x[ 0] = XOR(x[ 0], y4);
+        x[ 1] = XOR(x[ 1], y0);
+        x[ 2] = XOR(x[ 2], y1);
+        x[ 3] = XOR(x[ 3], y2);
+        x[ 4] = XOR(x[ 4], y3);
+        x[ 5] = XOR(x[ 5], y4);
+        x[ 6] = XOR(x[ 6], y0);
+        x[ 7] = XOR(x[ 7], y1);
+        x[ 8] = XOR(x[ 8], y2);
+        x[ 9] = XOR(x[ 9], y3);
+        x[10] = XOR(x[10], y4);
+        x[11] = XOR(x[11], y0);
+        x[12] = XOR(x[12], y1);
+        x[13] = XOR(x[13], y2);
+        x[14] = XOR(x[14], y3);
+        x[15] = XOR(x[15], y4);
+        x[16] = XOR(x[16], y0);
+        x[17] = XOR(x[17], y1);
+        x[18] = XOR(x[18], y2);
+        x[19] = XOR(x[19], y3);
+        x[20] = XOR(x[20], y4);
+        x[21] = XOR(x[21], y0);
+        x[22] = XOR(x[22], y1);
+        x[23] = XOR(x[23], y2);
+        x[24] = XOR(x[24], y3);
+
+        //  Rho Pi
+
+        t     = ROR(x[ 1], 63);
+        x[ 1] = ROR(x[ 6], 20);
+        x[ 6] = ROR(x[ 9], 44);
+        x[ 9] = ROR(x[22],  3);
+        x[22] = ROR(x[14], 25);
+        x[14] = ROR(x[20], 46);
+        x[20] = ROR(x[ 2],  2);
+        x[ 2] = ROR(x[12], 21);
+        x[12] = ROR(x[13], 39);
+        x[13] = ROR(x[19], 56);
+        x[19] = ROR(x[23],  8);
+        x[23] = ROR(x[15], 23);
+        x[15] = ROR(x[ 4], 37);
+        x[ 4] = ROR(x[24], 50);
+        x[24] = ROR(x[21], 62);
+        x[21] = ROR(x[ 8],  9);
+        x[ 8] = ROR(x[16], 19);
+        x[16] = ROR(x[ 5], 28);
+        x[ 5] = ROR(x[ 3], 36);
+        x[ 3] = ROR(x[18], 43);
+        x[18] = ROR(x[17], 49);
+        x[17] = ROR(x[11], 54);
+        x[11] = ROR(x[ 7], 58);
+        x[ 7] = ROR(x[10], 61);
+        x[10] = t;
+
+        //  Chi
+
+        t     =           ANDN(x[ 3], x[ 4]);
+        x[ 4] = XOR(x[ 4], ANDN(x[ 0], x[ 1]));
+        x[ 1] = XOR(x[ 1], ANDN(x[ 2], x[ 3]));
+        x[ 3] = XOR(x[ 3], ANDN(x[ 4], x[ 0]));
+        x[ 0] = XOR(x[ 0], ANDN(x[ 1], x[ 2]));
+        x[ 2] = XOR(x[ 2], t);
+
+        t     =           ANDN(x[ 8], x[ 9]);
+        x[ 9] = XOR(x[ 9], ANDN(x[ 5], x[ 6]));
+        x[ 6] = XOR(x[ 6], ANDN(x[ 7], x[ 8]));
+        x[ 8] = XOR(x[ 8], ANDN(x[ 9], x[ 5]));
+        x[ 5] = XOR(x[ 5], ANDN(x[ 6], x[ 7]));
+        x[ 7] = XOR(x[ 7], t);
+
+        t     =           ANDN(x[13], x[14]);
+        x[14] = XOR(x[14], ANDN(x[10], x[11]));
+        x[11] = XOR(x[11], ANDN(x[12], x[13]));
+        x[13] = XOR(x[13], ANDN(x[14], x[10]));
+        x[10] = XOR(x[10], ANDN(x[11], x[12]));
+        x[12] = XOR(x[12], t);
+
+        t     =           ANDN(x[18], x[19]);
+        x[19] = XOR(x[19], ANDN(x[15], x[16]));
+        x[16] = XOR(x[16], ANDN(x[17], x[18]));
+        x[18] = XOR(x[18], ANDN(x[19], x[15]));
+        x[15] = XOR(x[15], ANDN(x[16], x[17]));
+        x[17] = XOR(x[17], t);
+
+        t     =           ANDN(x[23], x[24]);
+        x[24] = XOR(x[24], ANDN(x[20], x[21]));
+        x[21] = XOR(x[21], ANDN(x[22], x[23]));
+        x[23] = XOR(x[23], ANDN(x[24], x[20]));
+        x[20] = XOR(x[20], ANDN(x[21], x[22]));
+        x[22] = XOR(x[22], t);
+
+        //  Iota
+
+        x[0] = XOR(x[0], _mm256_set1_epi64x(keccak_rc[i]));
+    }
+
+    for (i = 0; i < 25; i++) {
+        _mm256_storeu_si256(&v[i], x[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void keccak_f1600_x4_avx2(void *st)
+{
+    keccak_f1600_x4_body(st);
+}
+
+__attribute__((target("avx2,avx512f,avx512vl")))
+static void keccak_f1600_x4_avx512(void *st)
+{
+    keccak_f1600_x4_body(st);
+}
+
+#undef XOR
+#undef ANDN
+#undef ROR
+
+//  HASH_CPU_X86
+#endif
+
+//  === Portable fallback: four calls to the single permutation.
+
+static void keccak_f1600_x4_c(void *st)
+{
+    uint64_t (*v)[4] = (uint64_t (*)[4]) st;
+    uint64_t x[25];
+    int i, j;
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < 25; i++) {
+            x[i] = v[i][j];
+        }
+        keccak_f1600(x);
+        for (i = 0; i < 25; i++) {
+            v[i][j] = x[i];
+        }
+    }
+}
+
+//  runtime selection of the implementation
+
+void keccak_f1600_x4(void *st)
+{
+#ifdef HASH_CPU_X86
+    if (hash_cpu.level >= HASH_CPU_AVX512) {
+        SLH_COUNT_OP(SLH_CNT_KECCAK, 4);
+        keccak_f1600_x4_avx512(st);
+        return;
+    }
+    if (hash_cpu.level >= HASH_CPU_AVX2) {
+        SLH_COUNT_OP(SLH_CNT_KECCAK, 4);
+        keccak_f1600_x4_avx2(st);
+        return;
+    }
+#endif
+    keccak_f1600_x4_c(st);
+}
+
+//  SLOTH_KECCAK
+#endif
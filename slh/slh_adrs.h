@@ -147,6 +147,42 @@ static inline void adrs_set_type_and_clear_not_kp(slh_ctx_t *ctx, uint32_t y)
     ctx->adrs->u32[7] = 0;
 }
 
+//  === Multi-buffer lane addresses.
+
+static inline void lane_set_type(slh_lane_t *lane, uint32_t y)
+{
+    lane->adrs.u32[4] = rev8_be32(y);
+}
+
+static inline void lane_set_key_pair_address(slh_lane_t *lane, uint32_t x)
+{
+    lane->adrs.u32[5] = rev8_be32(x);
+}
+
+static inline void lane_set_chain_address(slh_lane_t *lane, uint32_t x)
+{
+    lane->adrs.u32[6] = rev8_be32(x);
+}
+
+static inline void lane_set_hash_address(slh_lane_t *lane, uint32_t x)
+{
+    lane->adrs.u32[7] = rev8_be32(x);
+}
+
+static inline uint32_t lane_get_hash_address(const slh_lane_t *lane)
+{
+    return rev8_be32(lane->adrs.u32[7]);
+}
+
+static inline void lane_set_tree_height(slh_lane_t *lane, uint32_t x)
+{
+    lane->adrs.u32[6] = rev8_be32(x);
+}
+
+static inline void lane_set_tree_index(slh_lane_t *lane, uint32_t x)
+{
+    lane->adrs.u32[7] = rev8_be32(x);
+}
 
 //  === Compressed 22-byte address ADRSc used with SHA-2.
 static inline void adrsc_22(const slh_ctx_t *ctx, uint8_t *ac)
@@ -161,6 +197,19 @@ static inline void adrsc_22(const slh_ctx_t *ctx, uint8_t *ac)
     }
 }
 
+//  === Compressed address ADRSc of a multi-buffer lane.
+static inline void lane_adrsc_22(const slh_lane_t *lane, uint8_t *ac)
+{
+    int i;
+    ac[0] = lane->adrs.u8[3];
+    for (i = 0; i < 8; i++) {
+        ac[i + 1] = lane->adrs.u8[i + 8];
+    }
+    for (i = 0; i < 13; i++) {
+        ac[i + 9] = lane->adrs.u8[i + 19];
+    }
+}
+
 //  _SLH_ADRS_H_
 #endif
 
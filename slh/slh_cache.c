@@ -0,0 +1,141 @@
+//  slh_cache.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === A simple built-in verification cache for the slh_vcache_t interface.
+
+#ifndef SLOTH
+
+#include "slh_dsa.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+//  largest value stored
+#define VCACHE_MAX_VAL 64
+
+//  a direct-mapped table of entries; a new entry replaces the old one
+
+typedef struct {
+    uint8_t         *key;                   //  NULL if unused
+    size_t          key_sz;
+    uint8_t         val[VCACHE_MAX_VAL];
+    size_t          val_sz;
+} vcache_ent_t;
+
+//  cache state; the first member makes (slh_vcache_t *) == (vcache_t *)
+
+typedef struct {
+    slh_vcache_t    vc;                     //  public interface
+    pthread_mutex_t mtx;
+    vcache_ent_t    *ent;
+    size_t          entries;
+} vcache_t;
+
+//  FNV-1a hash of the key selects the slot
+
+static size_t vcache_slot(  const vcache_t *vc,
+                            const uint8_t *key, size_t key_sz)
+{
+    uint64_t h = UINT64_C(0xCBF29CE484222325);
+    size_t i;
+
+    for (i = 0; i < key_sz; i++) {
+        h = (h ^ key[i]) * UINT64_C(0x100000001B3);
+    }
+    return (size_t) (h % vc->entries);
+}
+
+//  slh_vcache_t callbacks
+
+static bool vcache_get( void *cache, uint8_t *val, size_t val_sz,
+                        const uint8_t *key, size_t key_sz)
+{
+    vcache_t *vc = (vcache_t *) cache;
+    vcache_ent_t *e = &vc->ent[vcache_slot(vc, key, key_sz)];
+    bool found;
+
+    pthread_mutex_lock(&vc->mtx);
+    found = e->key != NULL && e->key_sz == key_sz && e->val_sz == val_sz &&
+            memcmp(e->key, key, key_sz) == 0;
+    if (found) {
+        memcpy(val, e->val, val_sz);
+    }
+    pthread_mutex_unlock(&vc->mtx);
+
+    return found;
+}
+
+static void vcache_put( void *cache, const uint8_t *val, size_t val_sz,
+                        const uint8_t *key, size_t key_sz)
+{
+    vcache_t *vc = (vcache_t *) cache;
+    vcache_ent_t *e = &vc->ent[vcache_slot(vc, key, key_sz)];
+    uint8_t *p;
+
+    if (val_sz > VCACHE_MAX_VAL)
+        return;
+
+    pthread_mutex_lock(&vc->mtx);
+    p = e->key;
+    if (p == NULL || e->key_sz != key_sz) {
+        p = (uint8_t *) realloc(e->key, key_sz);
+    }
+    if (p != NULL) {
+        memcpy(p, key, key_sz);
+        memcpy(e->val, val, val_sz);
+        e->key      = p;
+        e->key_sz   = key_sz;
+        e->val_sz   = val_sz;
+    }
+    pthread_mutex_unlock(&vc->mtx);
+}
+
+//  Create a built-in cache with room for "entries" entries.
+
+slh_vcache_t *slh_vcache_new(size_t entries)
+{
+    vcache_t *vc;
+
+    if (entries == 0)
+        return NULL;
+
+    vc = (vcache_t *) calloc(1, sizeof(vcache_t));
+    if (vc == NULL)
+        return NULL;
+
+    vc->ent = (vcache_ent_t *) calloc(entries, sizeof(vcache_ent_t));
+    if (vc->ent == NULL) {
+        free(vc);
+        return NULL;
+    }
+    vc->entries     = entries;
+    pthread_mutex_init(&vc->mtx, NULL);
+
+    vc->vc.get      = vcache_get;
+    vc->vc.put      = vcache_put;
+    vc->vc.cache    = vc;
+    vc->vc.entries  = entries;
+
+    return &vc->vc;
+}
+
+//  Free a cache created with slh_vcache_new().
+
+void slh_vcache_free(slh_vcache_t *p)
+{
+    vcache_t *vc = (vcache_t *) p;
+    size_t i;
+
+    if (vc == NULL)
+        return;
+
+    for (i = 0; i < vc->entries; i++) {
+        free(vc->ent[i].key);
+    }
+    pthread_mutex_destroy(&vc->mtx);
+    free(vc->ent);
+    free(vc);
+}
+
+//  SLOTH
+#endif
@@ -0,0 +1,76 @@
+//  slh_count.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Hash invocation counters (instrumentation build with -DSLH_COUNT).
+
+#ifdef SLH_COUNT
+
+#include "slh_count.h"
+#include <stddef.h>
+
+//  counters; updated atomically as the thread pool may be hashing
+static uint64_t cnt_tab[SLH_CNT_OPS][SLH_CNT_TYPES][SLH_CNT_LAYERS];
+
+//  key of the calling thread: ADRS type and layer of the last hash call
+static __thread uint32_t cnt_type = SLH_CNT_NO_ADRS;
+static __thread uint32_t cnt_layer = 0;
+
+void slh_count_hash(int op, const uint8_t *adrs, uint64_t x)
+{
+    if (adrs == NULL) {
+        cnt_type    = SLH_CNT_NO_ADRS;
+        cnt_layer   = 0;
+    } else {
+        //  low bytes of the big-endian layer address and type words
+        cnt_layer   = adrs[3] < SLH_CNT_LAYERS ? adrs[3] : SLH_CNT_LAYERS - 1;
+        cnt_type    = adrs[19] < SLH_CNT_NO_ADRS ? adrs[19] : SLH_CNT_NO_ADRS;
+    }
+    slh_count_op(op, x);
+}
+
+void slh_count_op(int op, uint64_t x)
+{
+    if (x > 0) {
+        __atomic_fetch_add(&cnt_tab[op][cnt_type][cnt_layer], x,
+                            __ATOMIC_RELAXED);
+    }
+}
+
+uint64_t slh_count_get(int op, int type, int layer)
+{
+    int i, j;
+    uint64_t x = 0;
+
+    if (op < 0 || op >= SLH_CNT_OPS ||
+        type >= SLH_CNT_TYPES || layer >= SLH_CNT_LAYERS)
+        return 0;
+
+    for (i = 0; i < SLH_CNT_TYPES; i++) {
+        if (type >= 0 && i != type)
+            continue;
+        for (j = 0; j < SLH_CNT_LAYERS; j++) {
+            if (layer < 0 || j == layer) {
+                x += __atomic_load_n(&cnt_tab[op][i][j], __ATOMIC_RELAXED);
+            }
+        }
+    }
+    return x;
+}
+
+void slh_count_reset(void)
+{
+    int i, j, k;
+
+    for (i = 0; i < SLH_CNT_OPS; i++) {
+        for (j = 0; j < SLH_CNT_TYPES; j++) {
+            for (k = 0; k < SLH_CNT_LAYERS; k++) {
+                __atomic_store_n(&cnt_tab[i][j][k], 0, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    cnt_type    = SLH_CNT_NO_ADRS;
+    cnt_layer   = 0;
+}
+
+//  SLH_COUNT
+#endif
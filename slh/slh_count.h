@@ -0,0 +1,68 @@
+//  slh_count.h
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Hash invocation counters (instrumentation build with -DSLH_COUNT).
+
+#ifndef _SLH_COUNT_H_
+#define _SLH_COUNT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+//  counted operations: slh_param_t hash functions and raw compressions
+#define SLH_CNT_F       0                   //  F (also each chain step)
+#define SLH_CNT_H       1                   //  H
+#define SLH_CNT_T       2                   //  T_l
+#define SLH_CNT_PRF     3                   //  PRF
+#define SLH_CNT_H_MSG   4                   //  H_msg
+#define SLH_CNT_PRF_MSG 5                   //  PRF_msg
+#define SLH_CNT_KECCAK  6                   //  keccak_f1600() per lane
+#define SLH_CNT_SHA256  7                   //  sha256_compress() per lane
+#define SLH_CNT_SHA512  8                   //  sha512_compress() per lane
+#define SLH_CNT_OPS     9
+
+//  counts are keyed by ADRS type (ADRS_WOTS_HASH .. ADRS_FORS_PRF) and the
+//  hypertree layer; calls without an address (H_msg, PRF_msg, set-up) go
+//  to type SLH_CNT_NO_ADRS, layer 0
+#define SLH_CNT_NO_ADRS 7
+#define SLH_CNT_TYPES   8
+#define SLH_CNT_LAYERS  32
+
+#ifdef SLH_COUNT
+
+//  Sum of the counts of operation "op" with ADRS type "type" and layer
+//  "layer"; a negative type or layer sums over all of them.
+uint64_t slh_count_get(int op, int type, int layer);
+
+//  Clear all counts.
+void slh_count_reset(void);
+
+//  (internal) Add x to "op" at the ADRS of the 32-byte "adrs" (or NULL),
+//  which also becomes the key of the compressions that follow in this
+//  thread. With x = 0 only the key is set.
+void slh_count_hash(int op, const uint8_t *adrs, uint64_t x);
+
+//  (internal) Add x to "op" at the current key of this thread.
+void slh_count_op(int op, uint64_t x);
+
+#define SLH_COUNT_HASH(op, adrs, x) \
+    slh_count_hash(op, (const uint8_t *) (adrs), x)
+#define SLH_COUNT_OP(op, x) slh_count_op(op, x)
+
+#else
+
+#define SLH_COUNT_HASH(op, adrs, x)
+#define SLH_COUNT_OP(op, x)
+
+//  SLH_COUNT
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+//  _SLH_COUNT_H_
+#endif
@@ -7,7 +7,9 @@
 #define _SLH_CTX_H_
 
 #include "slh_param.h"
+#include "slh_dsa.h"
 #include "sha2_api.h"
+#include "sha3_api.h"
 
 //  some structural sizes
 #define SLH_MAX_N   32
@@ -15,7 +17,10 @@
 #define SLH_MAX_K   35
 #define SLH_MAX_M   49
 #define SLH_MAX_HP  9
+#define SLH_MAX_D   22
 #define SLH_MAX_A   14
+#define SLH_MAX_X   16                      //  lanes per multi-buffer call
+#define SLH_READ_BUF 512                    //  slh_sign_read() buffer
 
 //  context
 struct slh_ctx_s {
@@ -35,6 +40,37 @@ struct slh_ctx_s {
     //  precomputed values
     sha256_t    sha256_pk_seed;
     sha512_t    sha512_pk_seed;
+
+    //  optional features (not set by mk_ctx; NULL if not used)
+    const slh_par_t *par;                   //  thread pool
+    const slh_vcache_t *vc;                 //  verification cache
+    const uint8_t *ht_node;                 //  stored top layer trees
+    uint32_t    ht_layers;                  //  number of stored layers
+    const slh_trace_t *trace;               //  phase trace callback
+};
+
+//  incremental message hash state
+union slh_msg_u {
+    sha3_ctx_t  sha3;
+    sha256_t    sha256;
+    sha512_t    sha512;
+};
+
+//  streaming verification (slh_stream.c)
+struct slh_vstream_s {
+    slh_ctx_t   ctx;                        //  context of public key
+    slh_msg_t   st;                         //  H_msg state
+    const uint8_t *sig;                     //  signature
+};
+
+//  signing and verification key objects (slh_key.c)
+struct slh_skey_s {
+    slh_ctx_t   ctx;                        //  prepared context
+    uint8_t     *node;                      //  allocated ctx.ht_node
+};
+
+struct slh_pkey_s {
+    slh_ctx_t   ctx;                        //  prepared context
 };
 
 //  === Lower-level functions
@@ -43,5 +79,55 @@ struct slh_ctx_s {
 size_t slh_do_sign( slh_ctx_t *ctx,
                     uint8_t *sig, const uint8_t *digest);
 
+//  Core verification function (of digest = H_msg(R, PK.seed, PK.root, M))
+//  with initialized context. *sig points to the signature, including R.
+bool slh_do_verify( slh_ctx_t *ctx,
+                    const uint8_t *sig, const uint8_t *digest);
+
+//  Incremental H_msg and PRF_msg implementations (slh_msg.c), and the
+//  one-shot versions built from them
+void shake_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r);
+void shake_h_msg_final( slh_ctx_t *ctx, slh_msg_t *st,
+                        uint8_t *h, const uint8_t *r);
+void shake_prf_msg_init(slh_ctx_t *ctx, slh_msg_t *st,
+                        const uint8_t *opt_rand);
+void shake_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h);
+void shake_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz);
+void shake_h_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                 const uint8_t *m, size_t m_sz);
+void shake_prf_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                   const uint8_t *m, size_t m_sz);
+
+void sha2_256_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r);
+void sha2_256_h_msg_final(  slh_ctx_t *ctx, slh_msg_t *st,
+                            uint8_t *h, const uint8_t *r);
+void sha256_prf_msg_init(   slh_ctx_t *ctx, slh_msg_t *st,
+                            const uint8_t *opt_rand);
+void sha256_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h);
+void sha256_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz);
+void sha2_256_h_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                    const uint8_t *m, size_t m_sz);
+void sha256_prf_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                    const uint8_t *m, size_t m_sz);
+
+void sha2_512_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r);
+void sha2_512_h_msg_final(  slh_ctx_t *ctx, slh_msg_t *st,
+                            uint8_t *h, const uint8_t *r);
+void sha512_prf_msg_init(   slh_ctx_t *ctx, slh_msg_t *st,
+                            const uint8_t *opt_rand);
+void sha512_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h);
+void sha512_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz);
+void sha2_512_h_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                    const uint8_t *m, size_t m_sz);
+void sha512_prf_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                    const uint8_t *m, size_t m_sz);
+
+//  Size in bytes of the XMSS trees of the top "layers" hypertree layers.
+size_t slh_ht_trees_sz(const slh_param_t *prm, uint32_t layers);
+
+//  Compute those trees to "node" (for ctx->ht_node), using ctx->par if set.
+//  Returns false if the root of the top layer does not match PK.root.
+bool slh_do_ht_trees(slh_ctx_t *ctx, uint8_t *node, uint32_t layers);
+
 //  _SLH_CTX_H_
 #endif
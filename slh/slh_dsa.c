@@ -8,8 +8,50 @@
 #include "slh_adrs.h"
 #include <assert.h>
 
+#ifdef SLOTH
+#include "sloth_hal.h"
+#endif
+
 //  === Internal
 
+//  Report the beginning or end of a phase to ctx->trace, if set.
+
+static inline void trace(   const slh_ctx_t *ctx, int phase, uint32_t layer,
+                            bool end)
+{
+    if (ctx->trace == NULL)
+        return;
+#ifdef SLOTH
+    ctx->trace->event(ctx->trace->arg, phase, layer, end, get_clk_ticks());
+#else
+    ctx->trace->event(ctx->trace->arg, phase, layer, end, plat_get_cycle());
+#endif
+}
+
+//  Create a private copy of a context for a worker thread.
+
+static void ctx_fork(slh_ctx_t *dst, const slh_ctx_t *src)
+{
+    *dst = *src;
+    dst->adrs = &dst->t_adrs;
+    dst->t_adrs = *src->adrs;
+    dst->par = NULL;
+    dst->vc = NULL;
+}
+
+//  Set up a context; also clears the optional features.
+
+static void mk_ctx( slh_ctx_t *ctx, const uint8_t *pk, const uint8_t *sk,
+                    const slh_param_t *prm)
+{
+    prm->mk_ctx(ctx, pk, sk, prm);
+    ctx->par = NULL;
+    ctx->vc = NULL;
+    ctx->ht_node = NULL;
+    ctx->ht_layers = 0;
+    ctx->trace = NULL;
+}
+
 //  helper functions to compute "len = len1 + len2"
 
 static inline uint32_t get_len1(const slh_param_t *prm)
@@ -94,7 +136,7 @@ static inline size_t base_16(   uint32_t *v, const uint8_t *x, int v_len)
 
 //  === Generate a WOTS+ public key.
 //  Algorithm 5: wots_PKgen(SK.seed, PK.seed, ADRS)
-//  (see xmms_node)
+//  (see xmss_leaf)
 
 //  === Generate a WOTS+ signature on an n-byte message.
 //  Algorithm 6: wots_sign(M, SK.seed, PK.seed, ADRS)
@@ -127,6 +169,94 @@ static void wots_csum(uint32_t *vm, const uint8_t *m, const slh_param_t *prm)
     base_16(&vm[len1], buf, len2);
 }
 
+//  Multi-buffer chains of different lengths: chain i of buf (in place)
+//  starts at hash address a[i] and takes s[i] steps. Each of the SLH_MAX_X
+//  lanes is refilled with the next chain as soon as its chain is done, and
+//  the longest chains go first so that few lanes are left idle at the end.
+
+static void wots_chains_x(  slh_ctx_t *ctx, uint8_t *buf,
+                            const uint32_t *a, const uint32_t *s,
+                            uint32_t len)
+{
+    const slh_param_t *prm = ctx->prm;
+    slh_lane_t lane[SLH_MAX_X];
+    uint32_t rem[SLH_MAX_X];
+    uint32_t ord[SLH_MAX_LEN];
+    uint32_t i, j, l, t;
+    size_t n = prm->n;
+
+    //  chains with steps, in decreasing order of length (s[i] <= 15)
+    l = 0;
+    for (t = 15; t > 0; t--) {
+        for (i = 0; i < len; i++) {
+            if (s[i] == t) {
+                ord[l++] = i;
+            }
+        }
+    }
+    len = l;
+
+    i = 0;
+    l = 0;
+    for (;;) {
+        while (l < SLH_MAX_X && i < len) {
+            j = ord[i++];
+            lane[l].ctx = ctx;
+            lane[l].adrs = *ctx->adrs;
+            lane_set_type(&lane[l], ADRS_WOTS_HASH);
+            lane_set_chain_address(&lane[l], j);
+            lane_set_hash_address(&lane[l], a[j]);
+            lane[l].h = buf + j * n;
+            lane[l].m1 = lane[l].h;
+            rem[l] = s[j];
+            l++;
+        }
+        if (l == 0)
+            break;
+        prm->h_f_x(lane, l);
+
+        //  advance; the last lane takes the place of a finished one
+        for (j = 0; j < l; ) {
+            if (--rem[j] == 0) {
+                l--;
+                lane[j] = lane[l];
+                rem[j] = rem[l];
+            } else {
+                t = lane_get_hash_address(&lane[j]);
+                lane_set_hash_address(&lane[j], t + 1);
+                j++;
+            }
+        }
+    }
+}
+
+//  Multi-buffer version of wots_sign(): the secret values of all chains,
+//  then chains of lengths vm[i] from hash address 0.
+
+static void wots_sign_x(slh_ctx_t *ctx, uint8_t *sig,
+                        const uint32_t *vm, uint32_t len)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i;
+    uint32_t a[SLH_MAX_LEN];
+    slh_lane_t lane[SLH_MAX_LEN];
+    size_t n = prm->n;
+
+    for (i = 0; i < len; i++) {
+        lane[i].ctx = ctx;
+        lane[i].adrs = *ctx->adrs;
+        lane_set_type(&lane[i], ADRS_WOTS_PRF);
+        lane_set_chain_address(&lane[i], i);
+        lane_set_hash_address(&lane[i], 0);
+        lane[i].h = sig + i * n;
+        lane[i].m1 = lane[i].h;
+        a[i] = 0;
+    }
+    prm->prf_x(lane, len);
+
+    wots_chains_x(ctx, sig, a, vm, len);
+}
+
 static size_t wots_sign(slh_ctx_t *ctx, uint8_t *sig, const uint8_t *m)
 {
     const slh_param_t *prm = ctx->prm;
@@ -137,6 +267,11 @@ static size_t wots_sign(slh_ctx_t *ctx, uint8_t *sig, const uint8_t *m)
     len = get_len(prm);
     wots_csum(vm, m, prm);
 
+    if (prm->prf_x != NULL && prm->h_f_x != NULL) {
+        wots_sign_x(ctx, sig, vm, len);
+        return n * len;
+    }
+
     for (i = 0; i < len; i++) {
         adrs_set_chain_address(ctx, i);
         prm->wots_chain(ctx, sig, vm[i]);
@@ -148,6 +283,39 @@ static size_t wots_sign(slh_ctx_t *ctx, uint8_t *sig, const uint8_t *m)
 //  === Compute a WOTS+ public key from a message and its signature.
 //  Algorithm 7: wots_PKFromSig(sig, M, PK.seed, ADRS)
 
+//  The chain values are collected to a buffer for h_t(): with multi-buffer
+//  chains (the remaining 15 - vm[i] steps of each), or without an
+//  incremental T_l.
+
+static void wots_pk_from_sig_buf(   slh_ctx_t *ctx, uint8_t *pk,
+                                    const uint8_t *sig,
+                                    const uint32_t *vm, uint32_t len)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i, t;
+    uint32_t rm[SLH_MAX_LEN];
+    uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
+    size_t n = prm->n;
+
+    t = 15; // (1 << prm->lg_w) - 1;
+
+    if (prm->h_f_x != NULL) {
+        memcpy(tmp, sig, len * n);
+        for (i = 0; i < len; i++) {
+            rm[i] = t - vm[i];
+        }
+        wots_chains_x(ctx, tmp, vm, rm, len);
+    } else {
+        for (i = 0; i < len; i++) {
+            adrs_set_chain_address(ctx, i);
+            prm->chain(ctx, tmp + i * n, sig + i * n, vm[i], t - vm[i]);
+        }
+    }
+
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t(ctx, pk, tmp, len * n);
+}
+
 static void wots_pk_from_sig(   slh_ctx_t *ctx, uint8_t *pk,
                                 const uint8_t *sig,
                                 const uint8_t *m)
@@ -155,77 +323,422 @@ static void wots_pk_from_sig(   slh_ctx_t *ctx, uint8_t *pk,
     const slh_param_t *prm = ctx->prm;
     uint32_t i, t, len;
     uint32_t vm[SLH_MAX_LEN];
-    uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
+    uint8_t tmp[SLH_MAX_N];
+    slh_msg_t st;
     size_t n = prm->n;
-    size_t tmp_sz;
 
     wots_csum(vm, m, prm);
-
     len = get_len(prm);
+
+    if (prm->h_f_x != NULL || prm->h_t_init == NULL) {
+        wots_pk_from_sig_buf(ctx, pk, sig, vm, len);
+        return;
+    }
+
+    //  each chain value goes directly to T_l (ADRS is of the WOTS_PK type)
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t_init(ctx, &st);
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_HASH);
+
     t = 15; // (1 << prm->lg_w) - 1;
-    tmp_sz = 0;
     for (i = 0; i < len; i++) {
         adrs_set_chain_address(ctx, i);
-        prm->chain( ctx, tmp + tmp_sz, sig + tmp_sz, vm[i], t - vm[i]);
-        tmp_sz += n;
+        prm->chain(ctx, tmp, sig + i * n, vm[i], t - vm[i]);
+        prm->msg_update(&st, tmp, n);
+    }
+
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t_final(ctx, &st, pk);
+}
+
+//  Multi-buffer version of the chains in wots_PKgen(): all len chains of
+//  key pairs i .. i + m - 1 are advanced together, SLH_MAX_X lanes at a
+//  time. The chains of several leaves fill the lanes that a single leaf
+//  would leave empty (len is not a multiple of the lane count.) Lanes are
+//  filled in chain order, so each group of results is absorbed into the
+//  T_l states st[0 .. m - 1] of the leaves as soon as it is ready.
+
+static void wots_pkgen_x(   slh_ctx_t *ctx, slh_msg_t *st,
+                            uint32_t i, uint32_t m)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t j, k, l;
+    slh_lane_t lane[SLH_MAX_X];
+    uint8_t tmp[SLH_MAX_X * SLH_MAX_N];
+    size_t n = prm->n;
+    uint32_t len = get_len(prm);
+
+    for (k = 0; k < m * len; k += l) {
+        l = m * len - k < SLH_MAX_X ? m * len - k : SLH_MAX_X;
+        for (j = 0; j < l; j++) {
+            lane[j].ctx = ctx;
+            lane[j].adrs = *ctx->adrs;
+            lane_set_type(&lane[j], ADRS_WOTS_PRF);
+            lane_set_key_pair_address(&lane[j], i + (k + j) / len);
+            lane_set_chain_address(&lane[j], (k + j) % len);
+            lane_set_hash_address(&lane[j], 0);
+            lane[j].h = tmp + j * n;
+            lane[j].m1 = lane[j].h;
+        }
+        prm->prf_x(lane, l);
+        for (j = 0; j < l; j++) {
+            lane_set_type(&lane[j], ADRS_WOTS_HASH);
+        }
+        prm->chain_x(lane, l, 15);          //  w-1 =  (1 << prm->lg_w) - 1;
+        for (j = 0; j < l; j++) {
+            prm->msg_update(&st[(k + j) / len], tmp + j * n, n);
+        }
+    }
+}
+
+//  Subtrees of 2**XMSS_TREE_C and 2**FORS_TREE_C leaves are built a level
+//  at a time; the larger FORS subtrees keep the upper levels mostly within
+//  the multi-buffer functions too (a is up to 14.)
+
+#define XMSS_TREE_C 4
+#define FORS_TREE_C 8
+
+//  Number of tree levels (c) hashed a level at a time with prm->h_h_x();
+//  subtrees of 2**c <= 2**c_max leaves, or single leaves if not available.
+
+static uint32_t tree_chunk(const slh_param_t *prm, uint32_t z, uint32_t c_max)
+{
+    uint32_t c = 0;
+
+    if (prm->h_h_x != NULL) {
+        while (c < z && c < c_max) {
+            c++;
+        }
+    }
+    return c;
+}
+
+//  Reduce 2**c nodes at height 0 in buf (first one has index i) into the
+//  root of their subtree at buf, with sibling pairs hashed in parallel,
+//  SLH_MAX_X / 2 pairs at a time. The ADRS type must be set. If auth != NULL,
+//  the authentication path nodes of leaf idx below height z are collected.
+
+static void tree_reduce_x(  slh_ctx_t *ctx, uint8_t *buf,
+                            uint32_t i, uint32_t c,
+                            uint8_t *auth, uint32_t idx, uint32_t z)
+{
+    const slh_param_t *prm = ctx->prm;
+    slh_lane_t lane[SLH_MAX_X / 2];
+    uint8_t tmp[(SLH_MAX_X / 2) * SLH_MAX_N];
+    uint32_t j, k, l, q, s, t;
+    size_t n = prm->n;
+
+    for (t = 0; ; t++) {
+        l = 1u << (c - t);                  //  nodes at height t
+        s = ((idx >> t) ^ 1) - (i >> t);    //  sibling on the auth path
+        if (auth != NULL && t < z && s < l) {
+            memcpy(auth + t * n, buf + s * n, n);
+        }
+        if (t == c)
+            break;
+
+        //  (node k + j at height t + 1 only overwrites nodes already read)
+        l >>= 1;
+        for (k = 0; k < l; k += q) {
+            q = l - k < SLH_MAX_X / 2 ? l - k : SLH_MAX_X / 2;
+            for (j = 0; j < q; j++) {
+                lane[j].ctx = ctx;
+                lane[j].adrs = *ctx->adrs;
+                lane_set_tree_height(&lane[j], t + 1);
+                lane_set_tree_index(&lane[j], (i >> (t + 1)) + k + j);
+                lane[j].h = tmp + j * n;
+                lane[j].m1 = buf + 2 * (k + j) * n;
+                lane[j].m2 = lane[j].m1 + n;
+            }
+            prm->h_h_x(lane, q);
+            memcpy(buf + k * n, tmp, q * n);
+        }
+    }
+}
+
+//  === Generate a WOTS+ public key.
+//  Algorithm 5: wots_PKgen(SK.seed, PK.seed, ADRS)
+//  (the leaf with key pair address i)
+
+static void xmss_leaf_buf(slh_ctx_t *ctx, uint8_t *pk, uint32_t i)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t k;
+    uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
+    uint8_t *sk;
+    size_t n = prm->n;
+    size_t len = get_len(prm);
+
+    adrs_set_key_pair_address(ctx, i);
+
+    sk  = tmp;
+    for (k = 0; k < len; k++) {
+        adrs_set_chain_address(ctx, k);
+        prm->wots_chain(ctx, sk, 15);       //  w-1 = (1 << lg_w) - 1;
+        sk += n;
+    }
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t(ctx, pk, tmp, len * n);
+}
+
+//  With an incremental T_l, each chain value is absorbed as it is computed.
+
+static void xmss_leaf(slh_ctx_t *ctx, uint8_t *pk, uint32_t i)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t k;
+    uint8_t tmp[SLH_MAX_N];
+    slh_msg_t st;
+    size_t n = prm->n;
+    size_t len = get_len(prm);
+
+    if (prm->h_t_init == NULL) {
+        xmss_leaf_buf(ctx, pk, i);
+        return;
+    }
+
+    adrs_set_key_pair_address(ctx, i);
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t_init(ctx, &st);
+
+    for (k = 0; k < len; k++) {
+        adrs_set_chain_address(ctx, k);
+        prm->wots_chain(ctx, tmp, 15);      //  w-1 = (1 << lg_w) - 1;
+        prm->msg_update(&st, tmp, n);
     }
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+    prm->h_t_final(ctx, &st, pk);
+}
+
+//  Multi-buffer leaves: the chains of XMSS_LEAF_X leaves at a time share
+//  the lanes; with 4 leaves at most a few percent of them are unused.
+
+#define XMSS_LEAF_X 4
+
+static void xmss_leaves_x(  slh_ctx_t *ctx, uint8_t *pk,
+                            uint32_t i, uint32_t l)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t j, k, m;
+    slh_msg_t st[XMSS_LEAF_X];
+    size_t n = prm->n;
 
     adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
-    prm->h_t(ctx, pk, tmp, tmp_sz);
+    for (j = 0; j < l; j += m) {
+        m = l - j < XMSS_LEAF_X ? l - j : XMSS_LEAF_X;
+        for (k = 0; k < m; k++) {
+            adrs_set_key_pair_address(ctx, i + j + k);
+            prm->h_t_init(ctx, &st[k]);
+        }
+        wots_pkgen_x(ctx, st, i + j, m);
+        for (k = 0; k < m; k++) {
+            adrs_set_key_pair_address(ctx, i + j + k);
+            prm->h_t_final(ctx, &st[k], pk + (j + k) * n);
+        }
+    }
+}
+
+//  The l leaves i .. i + l - 1 to pk. The multi-buffer leaves also need
+//  the incremental T_l, as they keep no buffer for the chain values.
+
+static void xmss_leaves(slh_ctx_t *ctx, uint8_t *pk, uint32_t i, uint32_t l)
+{
+    uint32_t j;
+
+    if (ctx->prm->chain_x != NULL && ctx->prm->h_t_init != NULL) {
+        xmss_leaves_x(ctx, pk, i, l);
+        return;
+    }
+    for (j = 0; j < l; j++) {
+        xmss_leaf(ctx, pk + j * ctx->prm->n, i + j);
+    }
 }
 
 //  === Compute the root of a Merkle subtree of WOTS+ public keys.
 //  Algorithm 8: xmss_node(SK.seed, i, z, PK.seed, ADRS)
 
-static void xmss_node(  slh_ctx_t *ctx, uint8_t *node,
-                        uint32_t i, uint32_t z)
+//  If auth != NULL, the authentication path of leaf idx is also collected
+//  while computing the full tree (i = 0, z = hp) in a single pass.
+
+static void xmss_node_auth( slh_ctx_t *ctx, uint8_t *node,
+                            uint32_t i, uint32_t z,
+                            uint8_t *auth, uint32_t idx)
 {
     const slh_param_t *prm = ctx->prm;
-    uint32_t j, k;
+    uint32_t c, j, k;
     int p;
     uint8_t *h0, h[SLH_MAX_HP][SLH_MAX_N];
-    uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
-    uint8_t *sk;
+    uint8_t buf[(1u << XMSS_TREE_C) * SLH_MAX_N];
     size_t n = prm->n;
-    size_t len = get_len(prm);
 
+    c = tree_chunk(prm, z, XMSS_TREE_C);
     p = -1;
     i <<= z;
-    for (j = 0; j < (1u << z); j++) {
-
-        adrs_set_key_pair_address(ctx, i);
+    for (j = 0; j < (1u << (z - c)); j++) {
 
-        //  === Generate a WOTS+ public key.
-        //  Algorithm 5: wots_PKgen(SK.seed, PK.seed, ADRS)
-        sk  = tmp;
-        for (k = 0; k < len; k++) {
-            adrs_set_chain_address(ctx, k);
-            prm->wots_chain(ctx, sk, 15);   //  w-1 =  (1 << prm->lg_w) - 1;
-            sk += n;
-        }
-        adrs_set_type_and_clear_not_kp(ctx, ADRS_WOTS_PK);
+        //  leaves i .. i + 2**c - 1 and their subtree
+        xmss_leaves(ctx, buf, i, 1u << c);
+        adrs_set_type_and_clear(ctx, ADRS_TREE);
+        tree_reduce_x(ctx, buf, i, c, auth, idx, z);
         h0 = p >= 0 ? h[p] : node;
         p++;
-        prm->h_t(ctx, h0, tmp, len * n);
+        memcpy(h0, buf, n);
 
         //  this xmss_node() implementation is non-recursive
-        for (k = 0; (j >> k) & 1; k++) {
+        for (k = c; (j >> (k - c)) & 1; k++) {
             adrs_set_type_and_clear(ctx, ADRS_TREE);
             adrs_set_tree_height(ctx, k + 1);
             adrs_set_tree_index(ctx, i >> (k + 1));
             p--;
             h0 = p >= 1 ? h[p - 1] : node;
             prm->h_h(ctx, h0, h0, h[p]);
+            if (auth != NULL && k + 1 < z &&
+                (i >> (k + 1)) == ((idx >> (k + 1)) ^ 1)) {
+                memcpy(auth + (k + 1) * n, h0, n);
+            }
+        }
+        i += 1u << c;       //  advance index
+    }
+}
+
+static void xmss_node(  slh_ctx_t *ctx, uint8_t *node,
+                        uint32_t i, uint32_t z)
+{
+    xmss_node_auth(ctx, node, i, z, NULL, 0);
+}
+
+//  === Stored XMSS trees of the top ctx->ht_layers hypertree layers.
+//  Each tree has 2**(hp + 1) - 1 nodes: the 2**hp leaves, then the nodes
+//  at height 1, 2, .., hp (root). Layer d - 1 comes first, followed by the
+//  2**hp trees of layer d - 2, and so on.
+
+static inline size_t ht_tree_sz(const slh_param_t *prm)
+{
+    return ((2u << prm->hp) - 1) * prm->n;
+}
+
+//  (position of node at height k, index i within a tree)
+static inline size_t ht_node_pos(   const slh_param_t *prm,
+                                    uint32_t k, uint32_t i)
+{
+    return ((2u << prm->hp) - (2u << (prm->hp - k)) + i) * prm->n;
+}
+
+//  (number of trees in the top "layers" layers)
+static uint64_t ht_trees(const slh_param_t *prm, uint32_t layers)
+{
+    uint32_t l;
+    uint64_t t = 0;
+
+    for (l = 0; l < layers; l++) {
+        t += UINT64_C(1) << (l * prm->hp);
+    }
+    return t;
+}
+
+size_t slh_ht_trees_sz(const slh_param_t *prm, uint32_t layers)
+{
+    return ht_trees(prm, layers) * ht_tree_sz(prm);
+}
+
+//  Return stored tree i_tree of layer j, or NULL if not available.
+
+static const uint8_t *ht_stored(const slh_ctx_t *ctx,
+                                uint32_t j, uint64_t i_tree)
+{
+    const slh_param_t *prm = ctx->prm;
+
+    if (ctx->ht_node == NULL || j + ctx->ht_layers < prm->d)
+        return NULL;
+    return ctx->ht_node +
+        (ht_trees(prm, prm->d - 1 - j) + i_tree) * ht_tree_sz(prm);
+}
+
+//  Copy the authentication path of leaf idx from a stored tree.
+
+static void ht_stored_auth( const slh_param_t *prm, uint8_t *auth,
+                            const uint8_t *tree, uint32_t idx)
+{
+    uint32_t j;
+    size_t n = prm->n;
+
+    for (j = 0; j < prm->hp; j++) {
+        memcpy(auth, tree + ht_node_pos(prm, j, (idx >> j) ^ 1), n);
+        auth += n;
+    }
+}
+
+//  Compute all nodes of the XMSS tree at the current layer and tree address.
+
+static void xmss_tree(slh_ctx_t *ctx, uint8_t *tree)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i, k;
+
+    xmss_leaves(ctx, tree + ht_node_pos(prm, 0, 0), 0, 1u << prm->hp);
+    adrs_set_type_and_clear(ctx, ADRS_TREE);
+    for (k = 1; k <= prm->hp; k++) {
+        adrs_set_tree_height(ctx, k);
+        for (i = 0; i < (1u << (prm->hp - k)); i++) {
+            adrs_set_tree_index(ctx, i);
+            prm->h_h(ctx,   tree + ht_node_pos(prm, k, i),
+                            tree + ht_node_pos(prm, k - 1, 2 * i),
+                            tree + ht_node_pos(prm, k - 1, 2 * i + 1));
+        }
+    }
+}
+
+//  (each tree of a layer is a separate job)
+
+typedef struct {
+    const slh_ctx_t *ctx;
+    uint8_t         *node;
+    uint32_t        j;
+} ht_trees_job_t;
+
+static void ht_trees_job(void *arg, uint32_t i)
+{
+    const ht_trees_job_t *job = (const ht_trees_job_t *) arg;
+    slh_ctx_t ctx;
+
+    ctx_fork(&ctx, job->ctx);
+    adrs_zero(&ctx);
+    adrs_set_layer_address(&ctx, job->j);
+    adrs_set_tree_address(&ctx, i);
+    xmss_tree(&ctx, job->node + i * ht_tree_sz(ctx.prm));
+}
+
+bool slh_do_ht_trees(slh_ctx_t *ctx, uint8_t *node, uint32_t layers)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i, l, t;
+    ht_trees_job_t job;
+
+    job.ctx = ctx;
+    for (l = 0; l < layers; l++) {
+        job.j       = prm->d - 1 - l;
+        job.node    = node + ht_trees(prm, l) * ht_tree_sz(prm);
+        t = 1u << (l * prm->hp);
+        if (ctx->par != NULL) {
+            ctx->par->par_for(ctx->par->pool, ht_trees_job, &job, t);
+        } else {
+            for (i = 0; i < t; i++) {
+                ht_trees_job(&job, i);
+            }
         }
-        i++;        //  advance index
     }
+
+    return layers == 0 ||
+        memcmp(node + ht_node_pos(prm, prm->hp, 0),
+                ctx->pk_root, prm->n) == 0;
 }
 
 //  === Generate an XMSS signature.
 //  Algorithm 9: xmss_sign(M, SK.seed, idx, PK.seed, ADRS)
 
+//  (if tree != NULL, the authentication path is taken from a stored tree)
 static size_t xmss_sign(slh_ctx_t *ctx, uint8_t *sx, const uint8_t *m,
-                        uint32_t idx)
+                        uint32_t idx, const uint8_t *tree)
 {
 
     const slh_param_t *prm = ctx->prm;
@@ -237,10 +750,14 @@ static size_t xmss_sign(slh_ctx_t *ctx, uint8_t *sx, const uint8_t *m,
     sx_sz = get_len(prm) * n;
     auth = sx + sx_sz;
 
-    for (j = 0; j < prm->hp; j++) {
-        k = (idx >> j) ^ 1;
-        xmss_node(ctx, auth, k, j);
-        auth += n;
+    if (tree != NULL) {
+        ht_stored_auth(prm, auth, tree, idx);
+    } else {
+        for (j = 0; j < prm->hp; j++) {
+            k = (idx >> j) ^ 1;
+            xmss_node(ctx, auth, k, j);
+            auth += n;
+        }
     }
     sx_sz += prm->hp * n;
 
@@ -296,25 +813,124 @@ static size_t ht_sign(  slh_ctx_t *ctx, uint8_t *sh, uint8_t *m,
     const slh_param_t *prm = ctx->prm;
     uint32_t j;
     size_t sx_sz;
+    const uint8_t *tree;
 
     adrs_zero(ctx);
     adrs_set_tree_address(ctx, i_tree);
-    sx_sz = xmss_sign(ctx, sh, m, i_leaf);
+    tree = ht_stored(ctx, 0, i_tree);
+    trace(ctx, SLH_TR_XMSS_SIGN, 0, false);
+    sx_sz = xmss_sign(ctx, sh, m, i_leaf, tree);
+    trace(ctx, SLH_TR_XMSS_SIGN, 0, true);
 
     for (j = 1; j < prm->d; j++) {
-        xmss_pk_from_sig(ctx, m, i_leaf, sh, m);
+        if (tree != NULL) {
+            memcpy(m, tree + ht_node_pos(prm, prm->hp, 0), prm->n);
+        } else {
+            trace(ctx, SLH_TR_XMSS_PK, j - 1, false);
+            xmss_pk_from_sig(ctx, m, i_leaf, sh, m);
+            trace(ctx, SLH_TR_XMSS_PK, j - 1, true);
+        }
         sh += sx_sz;
 
         i_leaf = i_tree & ((1 << prm->hp) - 1);
         i_tree >>= prm->hp;
         adrs_set_layer_address(ctx, j);
         adrs_set_tree_address(ctx, i_tree);
-        xmss_sign( ctx, sh, m, i_leaf);
+        tree = ht_stored(ctx, j, i_tree);
+        trace(ctx, SLH_TR_XMSS_SIGN, j, false);
+        xmss_sign( ctx, sh, m, i_leaf, tree);
+        trace(ctx, SLH_TR_XMSS_SIGN, j, true);
     }
 
     return sx_sz * prm->d;
 }
 
+//  parallel version: each layer's auth path and root only depends on
+//  (layer, i_tree, i_leaf), so all d trees are computed as independent
+//  jobs. The WOTS+ signatures of the roots are then created in a second
+//  round of jobs; xmss_pk_from_sig() is not needed at all.
+
+typedef struct {
+    const slh_ctx_t *ctx;
+    uint8_t         *sh;
+    const uint8_t   *m;
+    uint8_t         root[SLH_MAX_D * SLH_MAX_N];
+    uint64_t        i_tree[SLH_MAX_D];
+    uint32_t        i_leaf[SLH_MAX_D];
+} ht_job_t;
+
+//  (set up a private context for layer j)
+
+static void ht_job_ctx(slh_ctx_t *ctx, const ht_job_t *job, uint32_t j)
+{
+    ctx_fork(ctx, job->ctx);
+    adrs_zero(ctx);
+    adrs_set_layer_address(ctx, j);
+    adrs_set_tree_address(ctx, job->i_tree[j]);
+}
+
+static void ht_tree_job(void *arg, uint32_t j)
+{
+    ht_job_t *job = (ht_job_t *) arg;
+    const slh_param_t *prm = job->ctx->prm;
+    size_t n = prm->n;
+    size_t wots_sz = get_len(prm) * n;
+    uint8_t *auth = job->sh + j * (wots_sz + prm->hp * n) + wots_sz;
+    const uint8_t *tree;
+    slh_ctx_t ctx;
+
+    trace(job->ctx, SLH_TR_XMSS_SIGN, j, false);
+    tree = ht_stored(job->ctx, j, job->i_tree[j]);
+    if (tree != NULL) {
+        ht_stored_auth(prm, auth, tree, job->i_leaf[j]);
+        memcpy(job->root + j * n, tree + ht_node_pos(prm, prm->hp, 0), n);
+    } else {
+        ht_job_ctx(&ctx, job, j);
+        xmss_node_auth( &ctx, job->root + j * n, 0, prm->hp,
+                        auth, job->i_leaf[j]);
+    }
+    trace(job->ctx, SLH_TR_XMSS_SIGN, j, true);
+}
+
+static void ht_wots_job(void *arg, uint32_t j)
+{
+    ht_job_t *job = (ht_job_t *) arg;
+    const slh_param_t *prm = job->ctx->prm;
+    size_t n = prm->n;
+    slh_ctx_t ctx;
+
+    ht_job_ctx(&ctx, job, j);
+    adrs_set_type_and_clear_not_kp(&ctx, ADRS_WOTS_HASH);
+    adrs_set_key_pair_address(&ctx, job->i_leaf[j]);
+    wots_sign(  &ctx, job->sh + j * (get_len(prm) + prm->hp) * n,
+                j == 0 ? job->m : job->root + (j - 1) * n);
+}
+
+static size_t ht_sign_par(  slh_ctx_t *ctx, uint8_t *sh, const uint8_t *m,
+                            uint64_t i_tree, uint32_t i_leaf)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t j;
+    ht_job_t job;
+
+    assert(SLH_MAX_D >= prm->d);
+
+    for (j = 0; j < prm->d; j++) {
+        job.i_tree[j] = i_tree;
+        job.i_leaf[j] = i_leaf;
+        i_leaf = i_tree & ((1 << prm->hp) - 1);
+        i_tree >>= prm->hp;
+    }
+    job.ctx = ctx;
+    job.sh  = sh;
+    job.m   = m;
+
+    ctx->par->par_for(ctx->par->pool, ht_tree_job, &job, prm->d);
+    ctx->par->par_for(ctx->par->pool, ht_wots_job, &job, prm->d);
+
+    return (get_len(prm) + prm->hp) * prm->n * prm->d;
+}
+
 
 //  === Verify a hypertree signature.
 //  Algorithm 12: ht_verify(M, SIG_HT, PK.seed, idx_tree, idx_leaf, PK.root)
@@ -331,7 +947,9 @@ static bool ht_verify(  slh_ctx_t *ctx, const uint8_t *m,
     adrs_zero(ctx);
     adrs_set_tree_address(ctx, i_tree);
 
+    trace(ctx, SLH_TR_XMSS_PK, 0, false);
     xmss_pk_from_sig(ctx, node, i_leaf, sig_ht, m);
+    trace(ctx, SLH_TR_XMSS_PK, 0, true);
 
     st_sz = (prm->hp + get_len(prm)) * prm->n;
     for (j = 1; j < prm->d; j++) {
@@ -340,7 +958,9 @@ static bool ht_verify(  slh_ctx_t *ctx, const uint8_t *m,
         adrs_set_layer_address(ctx, j);
         adrs_set_tree_address(ctx, i_tree);
         sig_ht += st_sz;
+        trace(ctx, SLH_TR_XMSS_PK, j, false);
         xmss_pk_from_sig(ctx, node, i_leaf, sig_ht, node);
+        trace(ctx, SLH_TR_XMSS_PK, j, true);
     }
 
     uint8_t t;
@@ -351,11 +971,166 @@ static bool ht_verify(  slh_ctx_t *ctx, const uint8_t *m,
     return t == 0;
 }
 
-//  === Generate a FORS private-key value.
+//  The verification cache maps (layer j, tree, leaf, PK.seed, M, SIG_XMSS)
+//  to the root computed by xmss_pk_from_sig(). Layer j is cached only if
+//  all of the possible keys of layers j .. d - 1 fit in the cache.
+
+static uint32_t ht_vc_layer(const slh_param_t *prm, size_t entries)
+{
+    uint32_t j;
+    uint64_t s = 0;
+
+    for (j = prm->d - 1; j > 0; j--) {
+        s += UINT64_C(1) << ((prm->d - j) * prm->hp);
+        if (s > entries)
+            break;
+    }
+    return j + 1;
+}
+
+static size_t ht_vc_key(slh_ctx_t *ctx, uint8_t *key, uint32_t j,
+                        uint64_t i_tree, uint32_t i_leaf,
+                        const uint8_t *m, const uint8_t *sx)
+{
+    const slh_param_t *prm = ctx->prm;
+    size_t n = prm->n;
+    size_t sx_sz = (prm->hp + get_len(prm)) * n;
+
+    slh_tobyte(key, j, 4);
+    slh_tobyte(key + 4, i_tree, 8);
+    slh_tobyte(key + 12, i_leaf, 4);
+    memcpy(key + 16, ctx->pk_seed, n);
+    memcpy(key + 16 + n, m, n);
+    memcpy(key + 16 + 2 * n, sx, sx_sz);
+
+    return 16 + 2 * n + sx_sz;
+}
+
+//  ht_verify() with a verification cache (ctx->vc != NULL)
+
+static bool ht_verify_vc(   slh_ctx_t *ctx, const uint8_t *m,
+                            const uint8_t *sig_ht,
+                            uint64_t i_tree, uint32_t i_leaf)
+{
+    const slh_param_t *prm = ctx->prm;
+    const slh_vcache_t *vc = ctx->vc;
+    uint32_t i, j, j0;
+    uint8_t node[SLH_MAX_D][SLH_MAX_N];
+    uint8_t key[16 + (2 + SLH_MAX_HP + SLH_MAX_LEN) * SLH_MAX_N];
+    uint64_t tree[SLH_MAX_D];
+    uint32_t leaf[SLH_MAX_D];
+    bool hit[SLH_MAX_D];
+    size_t n = prm->n;
+    size_t key_sz, st_sz;
+
+    j0 = ht_vc_layer(prm, vc->entries);     //  lowest cached layer
+
+    adrs_zero(ctx);
+    adrs_set_tree_address(ctx, i_tree);
+
+    trace(ctx, SLH_TR_XMSS_PK, 0, false);
+    xmss_pk_from_sig(ctx, node[0], i_leaf, sig_ht, m);
+    trace(ctx, SLH_TR_XMSS_PK, 0, true);
+
+    st_sz = (prm->hp + get_len(prm)) * n;
+    for (j = 1; j < prm->d; j++) {
+        i_leaf = i_tree & ((1 << prm->hp) - 1);
+        i_tree >>= prm->hp;
+        tree[j] = i_tree;
+        leaf[j] = i_leaf;
+        sig_ht += st_sz;
+
+        hit[j] = false;
+        if (j >= j0) {
+            key_sz = ht_vc_key(ctx, key, j, i_tree, i_leaf,
+                                node[j - 1], sig_ht);
+            hit[j] = vc->get(vc->cache, node[j], n, key, key_sz);
+        }
+        if (!hit[j]) {
+            adrs_set_layer_address(ctx, j);
+            adrs_set_tree_address(ctx, i_tree);
+            trace(ctx, SLH_TR_XMSS_PK, j, false);
+            xmss_pk_from_sig(ctx, node[j], i_leaf, sig_ht, node[j - 1]);
+            trace(ctx, SLH_TR_XMSS_PK, j, true);
+        }
+    }
+
+    uint8_t t;
+    t = 0;
+    for (i = 0; i < n; i++) {
+        t |= node[prm->d - 1][i] ^ ctx->pk_root[i];
+    }
+
+    //  remember the new roots of a valid signature
+    if (t == 0) {
+        for (j = j0; j < prm->d; j++) {
+            if (!hit[j]) {
+                key_sz = ht_vc_key(ctx, key, j, tree[j], leaf[j], node[j - 1],
+                                    sig_ht - (prm->d - 1 - j) * st_sz);
+                vc->put(vc->cache, node[j], n, key, key_sz);
+            }
+        }
+    }
+
+    return t == 0;
+}
+
+//  === Generate a FORS private-key value.
 //  Algorithm 13: fors_SKgen(SK.seed, PK.seed, ADRS, idx)
 
 //  ( see prm->fors_hash() )
 
+//  fors_SKgen() + hash for l leaves starting from index i, SLH_MAX_X at
+//  a time with the multi-buffer functions
+
+static void fors_leaves(slh_ctx_t *ctx, uint8_t *buf, uint32_t i, uint32_t l)
+{
+    const slh_param_t *prm = ctx->prm;
+    slh_lane_t lane[SLH_MAX_X];
+    uint32_t j, k, q;
+    size_t n = prm->n;
+
+    if (prm->prf_x == NULL || prm->h_f_x == NULL) {
+        for (j = 0; j < l; j++) {
+            adrs_set_tree_index(ctx, i + j);
+            prm->fors_hash(ctx, buf + j * n, 1);
+        }
+        return;
+    }
+
+    for (k = 0; k < l; k += q) {
+        q = l - k < SLH_MAX_X ? l - k : SLH_MAX_X;
+        for (j = 0; j < q; j++) {
+            lane[j].ctx = ctx;
+            lane[j].adrs = *ctx->adrs;
+            lane_set_type(&lane[j], ADRS_FORS_PRF);
+            lane_set_tree_height(&lane[j], 0);
+            lane_set_tree_index(&lane[j], i + k + j);
+            lane[j].h = buf + (k + j) * n;
+            lane[j].m1 = lane[j].h;
+        }
+        prm->prf_x(lane, q);
+        for (j = 0; j < q; j++) {
+            lane_set_type(&lane[j], ADRS_FORS_TREE);
+        }
+        prm->h_f_x(lane, q);
+    }
+    adrs_set_type(ctx, ADRS_FORS_TREE);
+}
+
+//  Root of the FORS subtree of the 2**c leaves i .. i + 2**c - 1, built
+//  breadth-first: all leaves, then a level at a time.
+
+static void fors_subtree_x( slh_ctx_t *ctx, uint8_t *node,
+                            uint32_t i, uint32_t c)
+{
+    uint8_t buf[(1u << FORS_TREE_C) * SLH_MAX_N];
+
+    fors_leaves(ctx, buf, i, 1u << c);
+    tree_reduce_x(ctx, buf, i, c, NULL, 0, 0);
+    memcpy(node, buf, ctx->prm->n);
+}
+
 //  === Compute the root of a Merkle subtree of FORS public values.
 //  Algorithm 14: fors_node(SK.seed, i, z, PK.seed, ADRS)
 
@@ -364,57 +1139,97 @@ static void fors_node(  slh_ctx_t *ctx, uint8_t *node,
 {
     const slh_param_t *prm = ctx->prm;
     uint8_t h[SLH_MAX_A][SLH_MAX_N], *h0;
-    uint32_t j, k;
+    uint32_t c, j, k;
     int p;
 
+    c = tree_chunk(prm, z, FORS_TREE_C);
     p = -1;
     i <<= z;
-    for (j = 0; j < (1u << z); j++) {
+    for (j = 0; j < (1u << (z - c)); j++) {
 
-
-        //  fors_SKgen() + hash
-        adrs_set_tree_index(ctx, i);
+        //  leaves i .. i + 2**c - 1 and their subtree
         h0 = p >= 0 ? h[p] : node;
         p++;
-        prm->fors_hash(ctx, h0, 1);
+        if (c > 0) {
+            fors_subtree_x(ctx, h0, i, c);
+        } else {
+            fors_leaves(ctx, h0, i, 1);
+        }
 
         //  this fors_node() implementation is non-recursive
-        for (k = 0; (j >> k) & 1; k++) {
+        for (k = c; (j >> (k - c)) & 1; k++) {
             adrs_set_tree_height(ctx, k + 1);
             adrs_set_tree_index(ctx, i >> (k + 1));
             p--;
             h0 = p > 0 ? h[p - 1] : node;
             prm->h_h(ctx, h0, h0, h[p]);
         }
-        i++;        //  advance index
+        i += 1u << c;       //  advance index
     }
 }
 
-
 //  === Generate a FORS signature.
 //  Algorithm 15: fors_sign(md, SK.seed, PK.seed, ADRS)
 
+//  (the part of the signature for a single tree i with leaf index vi)
+static void fors_sign_tree( slh_ctx_t *ctx, uint8_t *sf,
+                            uint32_t i, uint32_t vi)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t j, s;
+    size_t  n = prm->n;
+
+    //  fors_SKgen()
+    adrs_set_tree_index(ctx, (i << prm->a) + vi);
+    prm->fors_hash(ctx, sf, 0);
+    sf += n;
+
+    for (j = 0; j < prm->a; j++) {
+        s = (vi >> j) ^ 1;
+        fors_node(  ctx, sf, (i << (prm->a - j)) + s, j);
+        sf += n;
+    }
+}
+
+//  parallel version: each of the k trees is a separate job
+
+typedef struct {
+    const slh_ctx_t *ctx;
+    uint8_t         *sf;
+    const uint32_t  *vi;
+} fors_job_t;
+
+static void fors_sign_job(void *arg, uint32_t i)
+{
+    const fors_job_t *job = (const fors_job_t *) arg;
+    const slh_param_t *prm = job->ctx->prm;
+    slh_ctx_t ctx;
+
+    ctx_fork(&ctx, job->ctx);
+    fors_sign_tree( &ctx, job->sf + i * (1 + prm->a) * prm->n,
+                    i, job->vi[i]);
+}
+
 static size_t fors_sign(slh_ctx_t *ctx, uint8_t *sf, const uint8_t *md)
 {
     const slh_param_t *prm = ctx->prm;
-    uint32_t i, j, s;
+    uint32_t i;
     uint32_t vi[SLH_MAX_K];
     size_t  n = prm->n;
+    fors_job_t job;
 
     assert(SLH_MAX_K >= prm->k);
     base_2b(vi, md, prm->a, prm->k);
 
-    for (i = 0; i < prm->k; i++) {
-
-        //  fors_SKgen()
-        adrs_set_tree_index(ctx, (i << prm->a) + vi[i]);
-        prm->fors_hash(ctx, sf, 0);
-        sf += n;
-
-        for (j = 0; j < prm->a; j++) {
-            s = (vi[i] >> j) ^ 1;
-            fors_node(  ctx, sf, (i << (prm->a - j)) + s, j);
-            sf += n;
+    if (ctx->par != NULL) {
+        job.ctx = ctx;
+        job.sf  = sf;
+        job.vi  = vi;
+        ctx->par->par_for(ctx->par->pool, fors_sign_job, &job, prm->k);
+    } else {
+        for (i = 0; i < prm->k; i++) {
+            fors_sign_tree(ctx, sf, i, vi[i]);
+            sf += (1 + prm->a) * n;
         }
     }
     return n * prm->k * (1 + prm->a);
@@ -423,49 +1238,86 @@ static size_t fors_sign(slh_ctx_t *ctx, uint8_t *sf, const uint8_t *md)
 //  === Compute a FORS public key from a FORS signature.
 //  Algorithm 16: fors_pkFromSig(SIGFORS , md, PK.seed, ADRS)
 
-static void fors_pk_from_sig(   slh_ctx_t *ctx, uint8_t *pk,
-                                const uint8_t *sf, const uint8_t *md)
-{
+//  The root of FORS tree i from its (a + 1) * n -byte part sf of SIG_FORS.
 
+static void fors_root(  slh_ctx_t *ctx, uint8_t *node,
+                        const uint8_t *sf, uint32_t i, uint32_t vi)
+{
     const slh_param_t *prm = ctx->prm;
-    uint32_t i, j, idx;
-    uint32_t vi[SLH_MAX_K];
-    uint8_t root[SLH_MAX_K * SLH_MAX_N];
-    uint8_t *node;
+    uint32_t j, idx;
     size_t  n = prm->n;
 
-    base_2b(vi, md, prm->a, prm->k);
+    adrs_set_tree_height(ctx, 0);
 
-    node = root;
-    for (i = 0; i < prm->k; i++) {
+    idx = (i << prm->a) + vi;
+    adrs_set_tree_index(ctx, idx);
 
-        adrs_set_tree_height(ctx, 0);
+    prm->h_f(ctx, node, sf);
+    sf += n;
 
-        idx = (i << prm->a) + vi[i];
-        adrs_set_tree_index(ctx, idx);
+    for (j = 0; j < prm->a; j++) {
 
-        prm->h_f(ctx, node, sf);
+        adrs_set_tree_height(ctx, j + 1);
+        adrs_set_tree_index(ctx, idx >> (j + 1));
+
+        if (((vi >> j) & 1) == 0) {
+            prm->h_h(ctx, node, node, sf);
+        } else {
+            prm->h_h(ctx, node, sf, node);
+        }
         sf += n;
+    }
+}
 
-        for (j = 0; j < prm->a; j++) {
+//  The k roots are collected to a buffer for h_t() without incremental T_l.
 
-            adrs_set_tree_height(ctx, j + 1);
-            adrs_set_tree_index(ctx, idx >> (j + 1));
+static void fors_pk_from_sig_buf(   slh_ctx_t *ctx, uint8_t *pk,
+                                    const uint8_t *sf, const uint32_t *vi)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i;
+    uint8_t root[SLH_MAX_K * SLH_MAX_N];
+    size_t  n = prm->n;
 
-            if (((vi[i] >> j) & 1) == 0) {
-                prm->h_h(ctx, node, node, sf);
-            } else {
-                prm->h_h(ctx, node, sf, node);
-            }
-            sf += n;
-        }
-        node += n;
+    for (i = 0; i < prm->k; i++) {
+        fors_root(ctx, root + i * n, sf + i * (prm->a + 1) * n, i, vi[i]);
     }
 
     adrs_set_type_and_clear_not_kp(ctx, ADRS_FORS_ROOTS);
     prm->h_t(ctx, pk, root, prm->k * n);
 }
 
+static void fors_pk_from_sig(   slh_ctx_t *ctx, uint8_t *pk,
+                                const uint8_t *sf, const uint8_t *md)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint32_t i;
+    uint32_t vi[SLH_MAX_K];
+    uint8_t node[SLH_MAX_N];
+    slh_msg_t st;
+    size_t  n = prm->n;
+
+    base_2b(vi, md, prm->a, prm->k);
+
+    if (prm->h_t_init == NULL) {
+        fors_pk_from_sig_buf(ctx, pk, sf, vi);
+        return;
+    }
+
+    //  each root goes directly to T_l (ADRS is of the FORS_ROOTS type)
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_FORS_ROOTS);
+    prm->h_t_init(ctx, &st);
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_FORS_TREE);
+
+    for (i = 0; i < prm->k; i++) {
+        fors_root(ctx, node, sf + i * (prm->a + 1) * n, i, vi[i]);
+        prm->msg_update(&st, node, n);
+    }
+
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_FORS_ROOTS);
+    prm->h_t_final(ctx, &st, pk);
+}
+
 //  === Public API
 
 //  Return standard identifier string for parameter set *prm, or NULL.
@@ -489,26 +1341,142 @@ size_t slh_sk_sz(const slh_param_t *prm)
 //  === Generate an SLH-DSA key pair.
 //  Algorithm 17: slh_keygen()
 
-int slh_keygen(uint8_t *pk, uint8_t *sk,
-               int (*rbg)(uint8_t *x, size_t xlen), const slh_param_t *prm)
+//  parallel version of the top tree: 2**s subtrees are separate jobs and
+//  their roots are then combined
+
+#define KG_MAX_JOBS 64
+
+typedef struct {
+    const slh_ctx_t *ctx;
+    uint8_t         node[KG_MAX_JOBS * SLH_MAX_N];
+    uint32_t        z;
+} kg_job_t;
+
+static void kg_tree_job(void *arg, uint32_t i)
+{
+    kg_job_t *job = (kg_job_t *) arg;
+    slh_ctx_t ctx;
+
+    ctx_fork(&ctx, job->ctx);
+    xmss_node(&ctx, job->node + i * ctx.prm->n, i, job->z);
+}
+
+static void xmss_root_par(slh_ctx_t *ctx, uint8_t *root)
 {
+    const slh_param_t *prm = ctx->prm;
+    const slh_par_t *par = ctx->par;
+    kg_job_t job;
+    uint32_t j, k, s;
+    size_t n = prm->n;
+
+    //  enough jobs for a few per thread
+    s = 0;
+    while (par != NULL && s < prm->hp && (2u << s) <= KG_MAX_JOBS &&
+            (1u << s) < 4 * par->threads) {
+        s++;
+    }
+    if (s == 0) {
+        xmss_node(ctx, root, 0, prm->hp);
+        return;
+    }
+
+    job.ctx = ctx;
+    job.z = prm->hp - s;
+    par->par_for(par->pool, kg_tree_job, &job, 1u << s);
+
+    for (k = job.z; k < prm->hp; k++) {
+        for (j = 0; j < (1u << (prm->hp - k - 1)); j++) {
+            adrs_set_type_and_clear(ctx, ADRS_TREE);
+            adrs_set_tree_height(ctx, k + 1);
+            adrs_set_tree_index(ctx, j);
+            prm->h_h(ctx, job.node + j * n,
+                    job.node + 2 * j * n, job.node + (2 * j + 1) * n);
+        }
+    }
+    memcpy(root, job.node, n);
+}
 
+//  (compute PK.root for sk = SK.seed || SK.prf || PK.seed)
+static void keygen_root(uint8_t *pk, uint8_t *sk,
+                        const slh_param_t *prm, const slh_par_t *par)
+{
     slh_ctx_t   ctx;
     uint8_t     pk_root[SLH_MAX_N];
     size_t      n = prm->n;
 
-    rbg(sk, 3 * n);                     //  SK.seed || SK.prf || PK.seed
     memcpy(pk, sk + 2 * n, n);          //  PK.seed
     memset(sk + 3 * n, 0x00, n);        //  PK.root not generated yet
-    prm->mk_ctx(&ctx, NULL, sk, prm);   //  fill in partial
+    mk_ctx(&ctx, NULL, sk, prm);        //  fill in partial
+    ctx.par = par;
 
     adrs_zero(&ctx);
     adrs_set_layer_address(&ctx, prm->d - 1);
-    xmss_node(&ctx, pk_root, 0, prm->hp);
+    xmss_root_par(&ctx, pk_root);
 
     //  fill pk_root
     memcpy(sk + 3 * n, pk_root, n);
     memcpy(pk + n, pk_root, n);
+}
+
+int slh_keygen_par( uint8_t *pk, uint8_t *sk,
+                    int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm, const slh_par_t *par)
+{
+    rbg(sk, 3 * prm->n);                //  SK.seed || SK.prf || PK.seed
+    keygen_root(pk, sk, prm, par);
+    return 0;
+}
+
+int slh_keygen(uint8_t *pk, uint8_t *sk,
+               int (*rbg)(uint8_t *x, size_t xlen), const slh_param_t *prm)
+{
+    return slh_keygen_par(pk, sk, rbg, prm, NULL);
+}
+
+//  batch version: each key pair is a separate job
+
+typedef struct {
+    uint8_t             *pk;
+    uint8_t             *sk;
+    const slh_param_t   *prm;
+} kg_batch_t;
+
+static void kg_batch_job(void *arg, uint32_t i)
+{
+    const kg_batch_t *job = (const kg_batch_t *) arg;
+    const slh_param_t *prm = job->prm;
+
+    keygen_root(job->pk + i * slh_pk_sz(prm), job->sk + i * slh_sk_sz(prm),
+                prm, NULL);
+}
+
+int slh_keygen_batch(   uint8_t *pk, uint8_t *sk, size_t num,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm, const slh_par_t *par)
+{
+    kg_batch_t job;
+    size_t i;
+
+    //  a single key: split its tree instead
+    if (num == 1) {
+        return slh_keygen_par(pk, sk, rbg, prm, par);
+    }
+
+    //  all of the seeds first, in order
+    for (i = 0; i < num; i++) {
+        rbg(sk + i * slh_sk_sz(prm), 3 * prm->n);
+    }
+
+    job.pk = pk;
+    job.sk = sk;
+    job.prm = prm;
+    if (par != NULL) {
+        par->par_for(par->pool, kg_batch_job, &job, (uint32_t) num);
+    } else {
+        for (i = 0; i < num; i++) {
+            kg_batch_job(&job, i);
+        }
+    }
     return 0;
 }
 
@@ -553,77 +1521,602 @@ size_t slh_do_sign( slh_ctx_t *ctx, uint8_t *sig, const uint8_t *digest)
     adrs_set_key_pair_address(ctx, i_leaf);
 
     //  SIG_FORS
+    trace(ctx, SLH_TR_FORS_SIGN, 0, false);
     sig_sz  = fors_sign(ctx, sig, md);
+    trace(ctx, SLH_TR_FORS_SIGN, 0, true);
+    trace(ctx, SLH_TR_FORS_PK, 0, false);
     fors_pk_from_sig(ctx, pk_fors, sig, md);
+    trace(ctx, SLH_TR_FORS_PK, 0, true);
 
     //  SIG_HT
     sig +=  sig_sz;
-    sig_sz  += ht_sign(ctx, sig, pk_fors, i_tree, i_leaf);
+    trace(ctx, SLH_TR_HT_SIGN, 0, false);
+    if (ctx->par != NULL) {
+        sig_sz  += ht_sign_par(ctx, sig, pk_fors, i_tree, i_leaf);
+    } else {
+        sig_sz  += ht_sign(ctx, sig, pk_fors, i_tree, i_leaf);
+    }
+    trace(ctx, SLH_TR_HT_SIGN, 0, true);
+
+    return sig_sz;
+}
+
+//  (signature with a set-up context and given opt_rand)
+static size_t slh_sign_rnd( slh_ctx_t *ctx, uint8_t *sig,
+                            const uint8_t *m, size_t m_sz,
+                            const uint8_t *opt_rand)
+{
+    const slh_param_t *prm = ctx->prm;
+    uint8_t digest[SLH_MAX_M];
+
+    //  randomized hashing; R
+    uint8_t *r  = sig;
+    size_t  sig_sz = prm->n;
+    trace(ctx, SLH_TR_PRF_MSG, 0, false);
+    prm->prf_msg(ctx, r, opt_rand, m, m_sz);
+    trace(ctx, SLH_TR_PRF_MSG, 0, true);
+    trace(ctx, SLH_TR_H_MSG, 0, false);
+    prm->h_msg(ctx, digest, r, m, m_sz);
+    trace(ctx, SLH_TR_H_MSG, 0, true);
+
+    //  create FORS and HT signature parts
+    sig_sz += slh_do_sign(ctx, sig + sig_sz, digest);
 
     return sig_sz;
 }
 
+//  (signature with a set-up context)
+static size_t slh_sign_ctx( slh_ctx_t *ctx, uint8_t *sig,
+                            const uint8_t *m, size_t m_sz,
+                            int (*rbg)(uint8_t *x, size_t xlen))
+{
+    uint8_t opt_rand[SLH_MAX_N];
+
+#ifdef SLH_DETERMINISTIC
+    (void) rbg;
+    memcpy(opt_rand, ctx->pk_seed, ctx->prm->n);
+#else
+    rbg(opt_rand, ctx->prm->n);
+#endif
+
+    return slh_sign_rnd(ctx, sig, m, m_sz, opt_rand);
+}
+
+size_t slh_sign_par(uint8_t *sig, const uint8_t *m, size_t m_sz,
+                    const uint8_t *sk, int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm, const slh_par_t *par)
+{
+    slh_ctx_t   ctx;
+
+    //  set up secret key etc
+    mk_ctx(&ctx, NULL, sk, prm);
+    ctx.par = par;
+
+    return slh_sign_ctx(&ctx, sig, m, m_sz, rbg);
+}
+
+size_t slh_sign_skey(   uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const slh_skey_t *key,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_par_t *par)
+{
+    slh_ctx_t   ctx;
+
+    //  private copy of the prepared context
+    ctx_fork(&ctx, &key->ctx);
+    ctx.par = par;
+
+    return slh_sign_ctx(&ctx, sig, m, m_sz, rbg);
+}
+
 size_t slh_sign(uint8_t *sig, const uint8_t *m, size_t m_sz,
                 const uint8_t *sk, int (*rbg)(uint8_t *x, size_t xlen),
                 const slh_param_t *prm)
+{
+    return slh_sign_par(sig, m, m_sz, sk, rbg, prm, NULL);
+}
+
+size_t slh_sign_trace(  uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm, const slh_trace_t *tr)
 {
     slh_ctx_t   ctx;
-    uint8_t opt_rand[SLH_MAX_N];
-    uint8_t digest[SLH_MAX_M];
 
-    //  set up secret key etc
-    prm->mk_ctx(&ctx, NULL, sk, prm);
+    mk_ctx(&ctx, NULL, sk, prm);
+    ctx.trace = tr;
+
+    return slh_sign_ctx(&ctx, sig, m, m_sz, rbg);
+}
+
+//  Signature of a message supplied by a reader callback; it is read twice.
+
+size_t slh_sign_read(   uint8_t *sig,
+                        size_t (*rd)(void *arg, uint8_t *buf, size_t sz,
+                                    uint64_t pos), void *rd_arg,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm)
+{
+    slh_ctx_t   ctx;
+    slh_msg_t   st;
+    uint8_t     opt_rand[SLH_MAX_N];
+    uint8_t     digest[SLH_MAX_M];
+    uint8_t     buf[SLH_READ_BUF];
+    uint64_t    pos;
+    size_t      l;
+
+    mk_ctx(&ctx, NULL, sk, prm);
 
 #ifdef SLH_DETERMINISTIC
+    (void) rbg;
     memcpy(opt_rand, ctx.pk_seed, prm->n);
 #else
     rbg(opt_rand, prm->n);
 #endif
 
     //  randomized hashing; R
-    uint8_t *r  = sig;
-    size_t  sig_sz = prm->n;
-    prm->prf_msg(&ctx, r, opt_rand, m, m_sz);
-    prm->h_msg(&ctx, digest, r, m, m_sz);
+    prm->prf_msg_init(&ctx, &st, opt_rand);
+    for (pos = 0; (l = rd(rd_arg, buf, sizeof(buf), pos)) > 0; pos += l) {
+        prm->msg_update(&st, buf, l);
+    }
+    prm->prf_msg_final(&ctx, &st, sig);
+
+    //  second pass
+    prm->h_msg_init(&ctx, &st, sig);
+    for (pos = 0; (l = rd(rd_arg, buf, sizeof(buf), pos)) > 0; pos += l) {
+        prm->msg_update(&st, buf, l);
+    }
+    prm->h_msg_final(&ctx, &st, digest, sig);
 
     //  create FORS and HT signature parts
-    sig_sz += slh_do_sign(&ctx, sig + sig_sz, digest);
+    return prm->n + slh_do_sign(&ctx, sig + prm->n, digest);
+}
 
-    return sig_sz;
+//  Verification of a message supplied by a reader callback; it is read once.
+
+bool slh_verify_read(   size_t (*rd)(void *arg, uint8_t *buf, size_t sz,
+                                    uint64_t pos), void *rd_arg,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm)
+{
+    slh_ctx_t   ctx;
+    slh_msg_t   st;
+    uint8_t     digest[SLH_MAX_M];
+    uint8_t     buf[SLH_READ_BUF];
+    uint64_t    pos;
+    size_t      l;
+
+    mk_ctx(&ctx, pk, NULL, prm);
+
+    //  R is the first part of the signature
+    prm->h_msg_init(&ctx, &st, sig);
+    for (pos = 0; (l = rd(rd_arg, buf, sizeof(buf), pos)) > 0; pos += l) {
+        prm->msg_update(&st, buf, l);
+    }
+    prm->h_msg_final(&ctx, &st, digest, sig);
+
+    return slh_do_verify(&ctx, sig, digest);
+}
+
+//  === Batch signing.
+//  opt_rand is drawn for each tuple in order by the caller, so the
+//  signatures are the same as with consecutive slh_sign() calls; each
+//  signature is then a separate job for the thread pool.
+
+#define SB_GROUP 64
+
+typedef struct {
+    const slh_stuple_t *st;
+    uint8_t (*opt_rand)[SLH_MAX_N];
+} sb_job_t;
+
+static void sb_job(void *arg, uint32_t i)
+{
+    const sb_job_t *job = (const sb_job_t *) arg;
+    const slh_stuple_t *st = &job->st[i];
+    slh_ctx_t ctx;
+
+    mk_ctx(&ctx, NULL, st->sk, st->prm);
+#ifdef SLH_DETERMINISTIC
+    memcpy(job->opt_rand[i], ctx.pk_seed, st->prm->n);
+#endif
+    slh_sign_rnd(&ctx, st->sig, st->m, st->m_sz, job->opt_rand[i]);
+}
+
+size_t slh_sign_batch(  const slh_stuple_t *st, size_t st_n,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_par_t *par)
+{
+    uint8_t opt_rand[SB_GROUP][SLH_MAX_N];
+    sb_job_t job;
+    uint32_t i, l;
+    size_t g;
+
+    job.opt_rand = opt_rand;
+    for (g = 0; g < st_n; g += l) {
+        l = st_n - g < SB_GROUP ? st_n - g : SB_GROUP;
+        job.st = st + g;
+#ifdef SLH_DETERMINISTIC
+        (void) rbg;
+#else
+        for (i = 0; i < l; i++) {
+            rbg(opt_rand[i], st[g + i].prm->n);
+        }
+#endif
+        if (par != NULL && l > 1) {
+            par->par_for(par->pool, sb_job, &job, l);
+        } else {
+            for (i = 0; i < l; i++) {
+                sb_job(&job, i);
+            }
+        }
+    }
+    return st_n;
 }
 
 //  === Verify an SLH-DSA signature.
 //  Algorithm 19: slh_verify(M, SIG, PK)
 
-bool slh_verify(const uint8_t *m, size_t m_sz,
-                const uint8_t *sig, const uint8_t *pk,
-                const slh_param_t *prm)
-{
+//  Core verification function that just takes in "digest" and an already
+//  initialized public key context. *sig points to the signature (with R.)
 
-    slh_ctx_t   ctx;
-    uint8_t digest[SLH_MAX_M];
+bool slh_do_verify( slh_ctx_t *ctx,
+                    const uint8_t *sig, const uint8_t *digest)
+{
+    const slh_param_t *prm = ctx->prm;
     uint8_t pk_fors[SLH_MAX_N];
 
-    const uint8_t   *r          = sig;
     const uint8_t   *sig_fors   = sig + prm->n;
     const uint8_t   *sig_ht     = sig + ((1 + prm->k*(1 + prm->a)) * prm->n);
 
-    prm->mk_ctx(&ctx, pk, NULL, prm);
-    prm->h_msg(&ctx, digest, r, m, m_sz);
-
     const uint8_t   *md = digest;
     uint64_t        i_tree = 0;
     uint32_t        i_leaf = 0;
     split_digest(&i_tree, &i_leaf, digest, prm);
 
-    adrs_zero(&ctx);
-    adrs_set_tree_address(&ctx, i_tree);
-    adrs_set_type_and_clear_not_kp(&ctx, ADRS_FORS_TREE);
-    adrs_set_key_pair_address(&ctx, i_leaf);
+    adrs_zero(ctx);
+    adrs_set_tree_address(ctx, i_tree);
+    adrs_set_type_and_clear_not_kp(ctx, ADRS_FORS_TREE);
+    adrs_set_key_pair_address(ctx, i_leaf);
 
-    fors_pk_from_sig(&ctx, pk_fors, sig_fors, md);
+    trace(ctx, SLH_TR_FORS_PK, 0, false);
+    fors_pk_from_sig(ctx, pk_fors, sig_fors, md);
+    trace(ctx, SLH_TR_FORS_PK, 0, true);
 
-    bool sig_ok = ht_verify(&ctx, pk_fors, sig_ht, i_tree, i_leaf);
+    trace(ctx, SLH_TR_HT_VERIFY, 0, false);
+    bool sig_ok = ctx->vc != NULL ?
+        ht_verify_vc(ctx, pk_fors, sig_ht, i_tree, i_leaf) :
+        ht_verify(ctx, pk_fors, sig_ht, i_tree, i_leaf);
+    trace(ctx, SLH_TR_HT_VERIFY, 0, true);
     return sig_ok;
 }
 
+//  (verification with a set-up context)
+static bool slh_verify_ctx( slh_ctx_t *ctx, const uint8_t *m, size_t m_sz,
+                            const uint8_t *sig)
+{
+    uint8_t digest[SLH_MAX_M];
+
+    trace(ctx, SLH_TR_H_MSG, 0, false);
+    ctx->prm->h_msg(ctx, digest, sig, m, m_sz);
+    trace(ctx, SLH_TR_H_MSG, 0, true);
+
+    return slh_do_verify(ctx, sig, digest);
+}
+
+bool slh_verify_vc( const uint8_t *m, size_t m_sz,
+                    const uint8_t *sig, const uint8_t *pk,
+                    const slh_param_t *prm, const slh_vcache_t *vc)
+{
+    slh_ctx_t   ctx;
+
+    mk_ctx(&ctx, pk, NULL, prm);
+    ctx.vc = vc;
+
+    return slh_verify_ctx(&ctx, m, m_sz, sig);
+}
+
+bool slh_verify_pkey(   const uint8_t *m, size_t m_sz,
+                        const uint8_t *sig, const slh_pkey_t *key,
+                        const slh_vcache_t *vc)
+{
+    slh_ctx_t   ctx;
+
+    //  private copy of the prepared context
+    ctx_fork(&ctx, &key->ctx);
+    ctx.vc = vc;
+
+    return slh_verify_ctx(&ctx, m, m_sz, sig);
+}
+
+bool slh_verify(const uint8_t *m, size_t m_sz,
+                const uint8_t *sig, const uint8_t *pk,
+                const slh_param_t *prm)
+{
+    return slh_verify_vc(m, m_sz, sig, pk, prm, NULL);
+}
+
+bool slh_verify_trace(  const uint8_t *m, size_t m_sz,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm, const slh_trace_t *tr)
+{
+    slh_ctx_t   ctx;
+
+    mk_ctx(&ctx, pk, NULL, prm);
+    ctx.trace = tr;
+
+    return slh_verify_ctx(&ctx, m, m_sz, sig);
+}
+
+
+//  === Batch verification.
+//  Up to SLH_MAX_X signatures of the same parameter set are verified in
+//  lockstep; the FORS trees, the WOTS+ chains, and the XMSS authentication
+//  paths of all of them are hashed together with the multi-buffer functions.
+
+typedef struct {
+    slh_ctx_t       ctx;
+    bool            ok;
+    const uint8_t   *sig_fors;
+    const uint8_t   *sig_ht;
+    uint64_t        i_tree;
+    uint32_t        i_leaf;
+    uint32_t        v[SLH_MAX_LEN];         //  FORS indices or WOTS+ digits
+    uint8_t         buf[SLH_MAX_LEN * SLH_MAX_N];
+    uint8_t         node[SLH_MAX_N];
+} vb_sig_t;
+
+//  lanes are collected and hashed SLH_MAX_X at a time
+
+typedef struct {
+    void            (*fn)(slh_lane_t *lane, uint32_t l);
+    slh_lane_t      lane[SLH_MAX_X];
+    uint32_t        l;
+} vb_queue_t;
+
+static void vb_flush(vb_queue_t *q)
+{
+    if (q->l > 0) {
+        q->fn(q->lane, q->l);
+        q->l = 0;
+    }
+}
+
+//  (new lane with the current address of *ctx)
+static slh_lane_t *vb_lane(vb_queue_t *q, slh_ctx_t *ctx)
+{
+    slh_lane_t *p;
+
+    if (q->l == SLH_MAX_X) {
+        vb_flush(q);
+    }
+    p = &q->lane[q->l++];
+    p->ctx = ctx;
+    p->adrs = *ctx->adrs;
+    return p;
+}
+
+//  (set the full address of signature s for layer j)
+static void vb_adrs(vb_sig_t *s, uint32_t j, uint32_t type)
+{
+    adrs_zero(&s->ctx);
+    adrs_set_layer_address(&s->ctx, j);
+    adrs_set_tree_address(&s->ctx, s->i_tree);
+    adrs_set_type_and_clear(&s->ctx, type);
+    if (type != ADRS_TREE) {
+        adrs_set_key_pair_address(&s->ctx, s->i_leaf);
+    }
+}
+
+//  (an authentication path step: node = H(node, auth) or H(auth, node))
+static void vb_auth(slh_lane_t *p, uint8_t *node, const uint8_t *auth,
+                    uint32_t idx, uint32_t k)
+{
+    lane_set_tree_height(p, k + 1);
+    lane_set_tree_index(p, idx >> (k + 1));
+    p->h = node;
+    if (((idx >> k) & 1) == 0) {
+        p->m1 = node;
+        p->m2 = auth;
+    } else {
+        p->m1 = auth;
+        p->m2 = node;
+    }
+}
+
+static void vb_verify(vb_sig_t *s, uint32_t b)
+{
+    const slh_param_t *prm = s[0].ctx.prm;
+    vb_queue_t  q;
+    uint32_t    i, j, k, t;
+    uint32_t    len = get_len(prm);
+    size_t      n = prm->n;
+    size_t      st_sz = (prm->hp + len) * n;
+    slh_lane_t  *p;
+
+    q.l = 0;
+
+    //  fors_pkFromSig(): leaves
+    q.fn = prm->h_f_x;
+    for (i = 0; i < b; i++) {
+        vb_adrs(&s[i], 0, ADRS_FORS_TREE);
+        for (k = 0; k < prm->k; k++) {
+            p = vb_lane(&q, &s[i].ctx);
+            lane_set_tree_height(p, 0);
+            lane_set_tree_index(p, (k << prm->a) + s[i].v[k]);
+            p->h = s[i].buf + k * n;
+            p->m1 = s[i].sig_fors + k * (prm->a + 1) * n;
+        }
+    }
+    vb_flush(&q);
+
+    //  .. authentication paths, a level at a time
+    q.fn = prm->h_h_x;
+    for (j = 0; j < prm->a; j++) {
+        for (i = 0; i < b; i++) {
+            for (k = 0; k < prm->k; k++) {
+                p = vb_lane(&q, &s[i].ctx);
+                vb_auth(p, s[i].buf + k * n,
+                        s[i].sig_fors + (k * (prm->a + 1) + 1 + j) * n,
+                        (k << prm->a) + s[i].v[k], j);
+            }
+        }
+        vb_flush(&q);
+    }
+
+    for (i = 0; i < b; i++) {
+        vb_adrs(&s[i], 0, ADRS_FORS_ROOTS);
+        prm->h_t(&s[i].ctx, s[i].node, s[i].buf, prm->k * n);
+    }
+
+    //  ht_verify()
+    for (j = 0; j < prm->d; j++) {
+
+        for (i = 0; i < b; i++) {
+            if (j > 0) {
+                s[i].i_leaf = s[i].i_tree & ((1 << prm->hp) - 1);
+                s[i].i_tree >>= prm->hp;
+                s[i].sig_ht += st_sz;
+            }
+            wots_csum(s[i].v, s[i].node, prm);
+            memcpy(s[i].buf, s[i].sig_ht, len * n);
+            vb_adrs(&s[i], j, ADRS_WOTS_HASH);
+        }
+
+        //  wots_PKFromSig(): chain i is at hash address t if v[i] <= t
+        q.fn = prm->h_f_x;
+        for (t = 0; t < 15; t++) {          //  w-1 =  (1 << prm->lg_w) - 1;
+            for (i = 0; i < b; i++) {
+                for (k = 0; k < len; k++) {
+                    if (s[i].v[k] <= t) {
+                        p = vb_lane(&q, &s[i].ctx);
+                        lane_set_chain_address(p, k);
+                        lane_set_hash_address(p, t);
+                        p->h = s[i].buf + k * n;
+                        p->m1 = p->h;
+                    }
+                }
+            }
+            vb_flush(&q);
+        }
+
+        for (i = 0; i < b; i++) {
+            vb_adrs(&s[i], j, ADRS_WOTS_PK);
+            prm->h_t(&s[i].ctx, s[i].node, s[i].buf, len * n);
+            vb_adrs(&s[i], j, ADRS_TREE);
+        }
+
+        //  xmss_PKFromSig(): authentication paths
+        q.fn = prm->h_h_x;
+        for (k = 0; k < prm->hp; k++) {
+            for (i = 0; i < b; i++) {
+                p = vb_lane(&q, &s[i].ctx);
+                vb_auth(p, s[i].node, s[i].sig_ht + (len + k) * n,
+                        s[i].i_leaf, k);
+            }
+            vb_flush(&q);
+        }
+    }
+
+    for (i = 0; i < b; i++) {
+        uint8_t x = 0;
+        for (k = 0; k < n; k++) {
+            x |= s[i].node[k] ^ s[i].ctx.pk_root[k];
+        }
+        s[i].ok = x == 0;
+    }
+}
+
+//  each group of SLH_MAX_X tuples is a separate job
+
+typedef struct {
+    const slh_vtuple_t *vt;
+    bool    *ok;
+    size_t  vt_n;
+} vb_job_t;
+
+static void vb_job(void *arg, uint32_t g)
+{
+    const vb_job_t *job = (const vb_job_t *) arg;
+    const slh_vtuple_t *vt = job->vt + (size_t) g * SLH_MAX_X;
+    const slh_param_t *prm;
+    vb_sig_t s[SLH_MAX_X];
+    uint32_t sel[SLH_MAX_X];
+    uint8_t digest[SLH_MAX_M];
+    bool done[SLH_MAX_X];
+    uint32_t i, j, b, l;
+    size_t n;
+
+    l = job->vt_n - (size_t) g * SLH_MAX_X < SLH_MAX_X ?
+        job->vt_n - (size_t) g * SLH_MAX_X : SLH_MAX_X;
+
+    for (i = 0; i < l; i++) {
+        done[i] = false;
+    }
+
+    //  the tuples of each parameter set separately
+    for (i = 0; i < l; i++) {
+        if (done[i])
+            continue;
+        prm = vt[i].prm;
+
+        if (prm->h_f_x == NULL || prm->h_h_x == NULL) {
+            job->ok[(vt - job->vt) + i] =
+                slh_verify(vt[i].m, vt[i].m_sz, vt[i].sig, vt[i].pk, prm);
+            done[i] = true;
+            continue;
+        }
+
+        b = 0;
+        for (j = i; j < l; j++) {
+            if (done[j] || vt[j].prm != prm)
+                continue;
+            done[j] = true;
+            sel[b] = j;
+
+            n = prm->n;
+            mk_ctx(&s[b].ctx, vt[j].pk, NULL, prm);
+            s[b].ctx.adrs = &s[b].ctx.t_adrs;   //  private address
+            prm->h_msg(&s[b].ctx, digest, vt[j].sig, vt[j].m, vt[j].m_sz);
+            split_digest(&s[b].i_tree, &s[b].i_leaf, digest, prm);
+            base_2b(s[b].v, digest, prm->a, prm->k);
+            s[b].sig_fors = vt[j].sig + n;
+            s[b].sig_ht = vt[j].sig + (1 + prm->k * (1 + prm->a)) * n;
+            b++;
+        }
+
+        vb_verify(s, b);
+        for (j = 0; j < b; j++) {
+            job->ok[(vt - job->vt) + sel[j]] = s[j].ok;
+        }
+    }
+}
+
+size_t slh_verify_batch(bool *ok, const slh_vtuple_t *vt, size_t vt_n,
+                        const slh_par_t *par)
+{
+    vb_job_t job;
+    uint32_t g, g_n;
+    size_t i, c;
+
+    job.vt = vt;
+    job.ok = ok;
+    job.vt_n = vt_n;
+
+    g_n = (uint32_t) ((vt_n + SLH_MAX_X - 1) / SLH_MAX_X);
+    if (par != NULL && g_n > 1) {
+        par->par_for(par->pool, vb_job, &job, g_n);
+    } else {
+        for (g = 0; g < g_n; g++) {
+            vb_job(&job, g);
+        }
+    }
+
+    c = 0;
+    for (i = 0; i < vt_n; i++) {
+        if (ok[i])
+            c++;
+    }
+    return c;
+}
@@ -49,18 +49,282 @@ int slh_keygen( uint8_t *pk, uint8_t *sk,
                 int (*rbg)(uint8_t *x, size_t xlen),
                 const slh_param_t *prm);
 
-//  Generate a SLH-DSA signature.
+//  Generate a SLH-DSA signature. The message is signed as given, as in the
+//  IPD; this is slh_sign_internal() of the final FIPS 205. See
+//  slh_pure_sign() for the final external interface with a context string.
 size_t slh_sign(uint8_t *sig,
                 const uint8_t *m, size_t m_sz,
                 const uint8_t *sk,
                 int (*rbg)(uint8_t *x, size_t xlen),
                 const slh_param_t *prm);
 
-//  Verify an SLH-DSA signature.
+//  Verify an SLH-DSA signature (slh_verify_internal() of final FIPS 205.)
 bool slh_verify(const uint8_t *m, size_t m_sz,
                 const uint8_t *sig, const uint8_t *pk,
                 const slh_param_t *prm);
 
+//  === Pure SLH-DSA with a context string (final FIPS 205)
+
+//  Generate a SLH-DSA signature of message m with a context string ctx of
+//  at most 255 bytes; slh_sign() of M' = 0x00 || len(ctx) || ctx || m.
+//  Returns 0 on failure.
+size_t slh_pure_sign(   uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const uint8_t *ctx, size_t ctx_sz,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm);
+
+//  Verify a SLH-DSA signature of message m with context string ctx.
+bool slh_pure_verify(   const uint8_t *m, size_t m_sz,
+                        const uint8_t *ctx, size_t ctx_sz,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm);
+
+//  === Pre-hash SLH-DSA (HashSLH-DSA)
+
+//  Pre-hash functions
+#define SLH_PH_SHA2_256 1
+#define SLH_PH_SHA2_512 2
+#define SLH_PH_SHAKE128 3
+#define SLH_PH_SHAKE256 4
+
+//  Return the size of the digest of pre-hash function ph, or 0.
+size_t slh_ph_sz(int ph);
+
+//  Compute the digest ph_m of message m with pre-hash function ph.
+//  Returns the size of the digest, or 0 if ph is not supported.
+size_t slh_ph_digest(uint8_t *ph_m, const uint8_t *m, size_t m_sz, int ph);
+
+//  Generate a HashSLH-DSA signature of digest ph_m = PH(M), with a context
+//  string ctx of at most 255 bytes. Returns 0 on failure.
+size_t slh_ph_sign( uint8_t *sig, const uint8_t *ph_m, int ph,
+                    const uint8_t *ctx, size_t ctx_sz,
+                    const uint8_t *sk, int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm);
+
+//  Verify a HashSLH-DSA signature of digest ph_m = PH(M).
+bool slh_ph_verify( const uint8_t *ph_m, int ph,
+                    const uint8_t *ctx, size_t ctx_sz,
+                    const uint8_t *sig, const uint8_t *pk,
+                    const slh_param_t *prm);
+
+//  === Streaming messages
+
+//  Generate a SLH-DSA signature of a message that is read with callback
+//  rd(rd_arg, buf, sz, pos); it must copy up to sz bytes from position pos
+//  to buf and return their number (0 at the end.) The message is read
+//  twice, since PRF_msg() must be complete before H_msg() can start.
+size_t slh_sign_read(   uint8_t *sig,
+                        size_t (*rd)(void *arg, uint8_t *buf, size_t sz,
+                                    uint64_t pos), void *rd_arg,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm);
+
+//  Verify a SLH-DSA signature of a message read with callback rd (as
+//  above); it is read once. Unlike the functions below, needs no heap.
+bool slh_verify_read(   size_t (*rd)(void *arg, uint8_t *buf, size_t sz,
+                                    uint64_t pos), void *rd_arg,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm);
+
+typedef struct slh_vstream_s slh_vstream_t;
+
+//  Start verifying signature sig with public key pk; NULL on failure.
+//  The signature must remain available until slh_verify_final().
+slh_vstream_t *slh_verify_init( const uint8_t *sig, const uint8_t *pk,
+                                const slh_param_t *prm);
+
+//  Process the next m_sz bytes of the message (nothing if vs is NULL.)
+void slh_verify_update(slh_vstream_t *vs, const uint8_t *m, size_t m_sz);
+
+//  Finish and free *vs. The result is the same as with slh_verify(),
+//  or false if vs is NULL.
+bool slh_verify_final(slh_vstream_t *vs);
+
+//  === Multi-threaded operation
+
+//  Thread pool interface. par_for(pool, fn, arg, n) must call fn(arg, i)
+//  exactly once for each i = 0, 1, .., n - 1 (in any order, from any thread)
+//  and return only after all of those calls have completed.
+typedef struct {
+    void    (*par_for)( void *pool, void (*fn)(void *arg, uint32_t i),
+                        void *arg, uint32_t n);
+    void    *pool;                          //  opaque pool handle
+    uint32_t threads;                       //  number of threads (hint)
+} slh_par_t;
+
+//  Create a built-in pool of "threads" threads (including the caller.)
+slh_par_t *slh_pool_new(uint32_t threads);
+
+//  Stop the workers and free a pool created with slh_pool_new().
+void slh_pool_free(slh_par_t *par);
+
+//  Generate an SLH-DSA key pair using thread pool *par (may be NULL.)
+//  The key pair is identical to the one created by slh_keygen().
+int slh_keygen_par( uint8_t *pk, uint8_t *sk,
+                    int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm, const slh_par_t *par);
+
+//  Generate num key pairs to pk[i * slh_pk_sz(prm)], sk[i * slh_sk_sz(prm)]
+//  using thread pool *par (may be NULL.) rbg is called in order from the
+//  calling thread, so the keys are identical to those of num slh_keygen()
+//  calls.
+int slh_keygen_batch(   uint8_t *pk, uint8_t *sk, size_t num,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm, const slh_par_t *par);
+
+//  Generate a SLH-DSA signature using thread pool *par (may be NULL.)
+//  The signature is identical to the one created by slh_sign().
+size_t slh_sign_par(uint8_t *sig,
+                    const uint8_t *m, size_t m_sz,
+                    const uint8_t *sk,
+                    int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm, const slh_par_t *par);
+
+//  One (secret key, message) signing job; the signature is written to sig.
+typedef struct {
+    uint8_t             *sig;               //  output signature
+    const uint8_t       *m;                 //  message
+    size_t              m_sz;
+    const uint8_t       *sk;                //  secret key
+    const slh_param_t   *prm;               //  parameter set
+} slh_stuple_t;
+
+//  Create st_n independent signatures st[0 .. st_n - 1] using thread pool
+//  *par (may be NULL.) rbg is called in order from the calling thread, so
+//  the signatures are identical to those of st_n slh_sign() calls.
+//  Returns the number of signatures created.
+size_t slh_sign_batch(  const slh_stuple_t *st, size_t st_n,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_par_t *par);
+
+//  === Prepared key objects
+
+//  Key objects hold a context that is set up once (seeds, SHA2 midstates),
+//  so that it is not repeated for each operation. They are not modified by
+//  signing or verification and may be shared by several threads.
+
+typedef struct slh_skey_s slh_skey_t;
+typedef struct slh_pkey_s slh_pkey_t;
+
+//  Create a signing key object for secret key sk. The XMSS trees of as many
+//  top hypertree layers as fit in mem_max bytes (may be 0) are computed
+//  (using thread pool *par, may be NULL) and kept. Returns NULL on failure.
+slh_skey_t *slh_skey_new(   const uint8_t *sk, const slh_param_t *prm,
+                            size_t mem_max, const slh_par_t *par);
+
+//  Free a signing key object.
+void slh_skey_free(slh_skey_t *key);
+
+//  Generate a SLH-DSA signature with signing key object *key; thread pool
+//  *par may be NULL. The signature is identical to the one by slh_sign().
+size_t slh_sign_skey(   uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const slh_skey_t *key,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_par_t *par);
+
+//  Create a verification key object for public key pk; NULL on failure.
+slh_pkey_t *slh_pkey_new(const uint8_t *pk, const slh_param_t *prm);
+
+//  Free a verification key object.
+void slh_pkey_free(slh_pkey_t *key);
+
+//  === Verification cache
+
+//  Cache interface. get(cache, val, val_sz, key, key_sz) copies the value
+//  stored for key to val and returns true if found, put() adds an entry
+//  (and may drop others.) Both may be called from several threads at once.
+typedef struct {
+    bool    (*get)( void *cache, uint8_t *val, size_t val_sz,
+                    const uint8_t *key, size_t key_sz);
+    void    (*put)( void *cache, const uint8_t *val, size_t val_sz,
+                    const uint8_t *key, size_t key_sz);
+    void    *cache;                         //  opaque cache handle
+    size_t  entries;                        //  capacity (hint)
+} slh_vcache_t;
+
+//  Create a built-in cache with room for "entries" entries.
+slh_vcache_t *slh_vcache_new(size_t entries);
+
+//  Free a cache created with slh_vcache_new().
+void slh_vcache_free(slh_vcache_t *vc);
+
+//  Verify an SLH-DSA signature using verification cache *vc (may be NULL.)
+//  The result is always the same as with slh_verify(). Upper hypertree
+//  layers of successfully verified signatures are remembered, so that the
+//  XMSS roots of a layer are not recomputed for an identical input.
+bool slh_verify_vc( const uint8_t *m, size_t m_sz,
+                    const uint8_t *sig, const uint8_t *pk,
+                    const slh_param_t *prm, const slh_vcache_t *vc);
+
+//  Verify an SLH-DSA signature with verification key object *key; cache
+//  *vc may be NULL. The result is the same as with slh_verify().
+bool slh_verify_pkey(   const uint8_t *m, size_t m_sz,
+                        const uint8_t *sig, const slh_pkey_t *key,
+                        const slh_vcache_t *vc);
+
+//  === Batch verification
+
+//  One (message, signature, public key) tuple.
+typedef struct {
+    const uint8_t       *m;                 //  message
+    size_t              m_sz;
+    const uint8_t       *sig;               //  signature
+    const uint8_t       *pk;                //  public key
+    const slh_param_t   *prm;               //  parameter set
+} slh_vtuple_t;
+
+//  Verify vt_n independent signatures vt[0 .. vt_n - 1] using thread pool
+//  *par (may be NULL.) Sets ok[i] to the result of slh_verify() for vt[i];
+//  returns the number of valid signatures.
+size_t slh_verify_batch(bool *ok, const slh_vtuple_t *vt, size_t vt_n,
+                        const slh_par_t *par);
+
+//  === Phase tracing
+
+//  Phases of signing and verification. XMSS_SIGN and XMSS_PK (the root of
+//  a layer computed from its signature) are reported for each hypertree
+//  layer; with a thread pool, XMSS_SIGN covers the authentication path and
+//  root of the layer, and the WOTS+ signatures are only within HT_SIGN.
+#define SLH_TR_PRF_MSG      0
+#define SLH_TR_H_MSG        1
+#define SLH_TR_FORS_SIGN    2
+#define SLH_TR_FORS_PK      3
+#define SLH_TR_HT_SIGN      4
+#define SLH_TR_HT_VERIFY    5
+#define SLH_TR_XMSS_SIGN    6
+#define SLH_TR_XMSS_PK      7
+
+//  Trace interface. event(arg, phase, layer, end, t) is called at the
+//  beginning (end = false) and end (end = true) of each phase, with cycle
+//  count t (clock ticks on SLotH.) With a thread pool it may be called
+//  from several threads at once.
+typedef struct {
+    void    (*event)(   void *arg, int phase, uint32_t layer, bool end,
+                        uint64_t t);
+    void    *arg;                           //  opaque callback argument
+} slh_trace_t;
+
+//  Report the phases of operations with signing key object *key to *tr
+//  (NULL to stop.) Must not be called while the key is in use.
+void slh_skey_trace(slh_skey_t *key, const slh_trace_t *tr);
+
+//  The same for verification key object *key.
+void slh_pkey_trace(slh_pkey_t *key, const slh_trace_t *tr);
+
+//  Generate a SLH-DSA signature like slh_sign(), reporting its phases to
+//  *tr (may be NULL.) Also available on SLotH, which has no key objects.
+size_t slh_sign_trace(  uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm, const slh_trace_t *tr);
+
+//  Verify an SLH-DSA signature like slh_verify(), reporting its phases.
+bool slh_verify_trace(  const uint8_t *m, size_t m_sz,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm, const slh_trace_t *tr);
+
 #ifdef __cplusplus
 }
 #endif
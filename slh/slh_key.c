@@ -0,0 +1,99 @@
+//  slh_key.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Prepared signing and verification key objects.
+
+#ifndef SLOTH
+
+#include "slh_ctx.h"
+#include <stdlib.h>
+#include <string.h>
+
+//  Create a signing key object for secret key sk.
+
+slh_skey_t *slh_skey_new(   const uint8_t *sk, const slh_param_t *prm,
+                            size_t mem_max, const slh_par_t *par)
+{
+    slh_skey_t *key;
+    uint32_t layers;
+
+    key = (slh_skey_t *) calloc(1, sizeof(slh_skey_t));
+    if (key == NULL)
+        return NULL;
+    prm->mk_ctx(&key->ctx, NULL, sk, prm);  //  (optional features cleared)
+
+    //  as many layers as fit (each par_for job count is 32-bit)
+    layers = 0;
+    while ( layers < prm->d && layers * prm->hp < 32 &&
+            slh_ht_trees_sz(prm, layers + 1) <= mem_max) {
+        layers++;
+    }
+
+    if (layers > 0) {
+        key->node = (uint8_t *) malloc(slh_ht_trees_sz(prm, layers));
+        if (key->node == NULL) {
+            free(key);
+            return NULL;
+        }
+        key->ctx.par = par;
+        if (!slh_do_ht_trees(&key->ctx, key->node, layers)) {
+            slh_skey_free(key);             //  PK.root mismatch
+            return NULL;
+        }
+        key->ctx.par = NULL;
+        key->ctx.ht_node = key->node;
+        key->ctx.ht_layers = layers;
+    }
+
+    return key;
+}
+
+//  Free a signing key object.
+
+void slh_skey_free(slh_skey_t *key)
+{
+    if (key == NULL)
+        return;
+
+    free(key->node);                        //  (public values)
+    memset(key, 0, sizeof(slh_skey_t));     //  clear secret key material
+    free(key);
+}
+
+//  Report the phases of operations with the key to *tr (NULL to stop.)
+
+void slh_skey_trace(slh_skey_t *key, const slh_trace_t *tr)
+{
+    key->ctx.trace = tr;
+}
+
+//  Create a verification key object for public key pk.
+
+slh_pkey_t *slh_pkey_new(const uint8_t *pk, const slh_param_t *prm)
+{
+    slh_pkey_t *key;
+
+    key = (slh_pkey_t *) calloc(1, sizeof(slh_pkey_t));
+    if (key == NULL)
+        return NULL;
+    prm->mk_ctx(&key->ctx, pk, NULL, prm);  //  (optional features cleared)
+
+    return key;
+}
+
+//  Free a verification key object.
+
+void slh_pkey_free(slh_pkey_t *key)
+{
+    free(key);
+}
+
+//  Report the phases of operations with the key to *tr (NULL to stop.)
+
+void slh_pkey_trace(slh_pkey_t *key, const slh_trace_t *tr)
+{
+    key->ctx.trace = tr;
+}
+
+//  SLOTH
+#endif
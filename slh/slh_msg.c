@@ -0,0 +1,327 @@
+//  slh_msg.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Incremental H_msg and PRF_msg for streaming messages.
+
+#include "slh_ctx.h"
+#include "sha3_api.h"
+#include "sha2_api.h"
+#include "slh_count.h"
+#include <string.h>
+
+//  === 10.1.   SLH-DSA Using SHAKE
+
+//  Hmsg(R, PK.seed, PK.root, M) = SHAKE256(R || PK.seed || PK.root || M, 8m)
+
+void shake_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r)
+{
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_H_MSG, NULL, 1);
+
+    shake256_init(&st->sha3);
+    shake_update(&st->sha3, r, n);
+    shake_update(&st->sha3, ctx->pk_seed, n);
+    shake_update(&st->sha3, ctx->pk_root, n);
+}
+
+void shake_h_msg_final( slh_ctx_t *ctx, slh_msg_t *st,
+                        uint8_t *h, const uint8_t *r)
+{
+    (void) r;
+    shake_out(&st->sha3, h, ctx->prm->m);
+}
+
+//  PRFmsg (SK.prf, opt_rand, M) = SHAKE256(SK.prf || opt_rand || M, 8n)
+
+void shake_prf_msg_init(slh_ctx_t *ctx, slh_msg_t *st,
+                        const uint8_t *opt_rand)
+{
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_PRF_MSG, NULL, 1);
+
+    shake256_init(&st->sha3);
+    shake_update(&st->sha3, ctx->sk_prf, n);
+    shake_update(&st->sha3, opt_rand, n);
+}
+
+void shake_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    shake_out(&st->sha3, h, ctx->prm->n);
+}
+
+void shake_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz)
+{
+    shake_update(&st->sha3, m, m_sz);
+}
+
+//  one-shot versions for the parameter set tables
+
+void shake_h_msg(   slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    shake_h_msg_init(ctx, &st, r);
+    shake_msg_update(&st, m, m_sz);
+    shake_h_msg_final(ctx, &st, h, r);
+}
+
+void shake_prf_msg( slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    shake_prf_msg_init(ctx, &st, opt_rand);
+    shake_msg_update(&st, m, m_sz);
+    shake_prf_msg_final(ctx, &st, h);
+}
+
+//  === 10.2.   SLH-DSA Using SHA2 for Security Category 1
+
+//  Cat 1: Hmsg(R, PK.seed, PK.root, M) =
+//      MGF1-SHA-256(R || PK.seed || SHA-256(R ||PK.seed || PK.root || M), m)
+
+void sha2_256_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r)
+{
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_H_MSG, NULL, 1);
+
+    sha256_init(&st->sha256);
+    sha256_update(&st->sha256, r, n);
+    sha256_update(&st->sha256, ctx->pk_seed, n);
+    sha256_update(&st->sha256, ctx->pk_root, n);
+}
+
+void sha2_256_h_msg_final(  slh_ctx_t *ctx, slh_msg_t *st,
+                            uint8_t *h, const uint8_t *r)
+{
+    sha256_t sha2;
+    uint8_t mgf[16 + 16 + 32 + 4];
+    size_t  n = ctx->prm->n;
+
+    //  MGF1-SHA-256(R || PK.seed || ..
+    memcpy(mgf, r, n);
+    memcpy(mgf + n, ctx->pk_seed, n);
+    sha256_final(&st->sha256, mgf + 2 * n);
+
+    size_t mgf_sz = 2 * n + 32 + 4;
+    uint8_t *ctr = mgf + mgf_sz - 4;
+
+    //  MGF1 counter mode
+    for (size_t i = 0; i < ctx->prm->m; i += 32) {
+        uint32_t c = i / 32;
+        ctr[0] = c >> 24;
+        ctr[1] = (c >> 16) & 0xFF;
+        ctr[2] = (c >> 8) & 0xFF;
+        ctr[3] = c & 0xFF;
+
+        sha256_init(&sha2);
+        sha256_update(&sha2, mgf, mgf_sz);
+        if ((ctx->prm->m - i) >= 32) {
+            sha256_final(&sha2, h + i);
+        } else {
+            sha256_final(&sha2, mgf);
+            memcpy(h + i, mgf, ctx->prm->m - i);
+        }
+    }
+}
+
+//  Cat 1: PRFmsg(SK.prf, opt_rand, M) =
+//      Trunc_n(HMAC-SHA-256(SK.prf, opt_rand || M))
+
+void sha256_prf_msg_init(   slh_ctx_t *ctx, slh_msg_t *st,
+                            const uint8_t *opt_rand)
+{
+    unsigned i;
+    uint8_t pad[64];
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_PRF_MSG, NULL, 1);
+
+    //  ipad
+    memcpy(pad, ctx->sk_prf, n);
+    for (i = 0; i < n; i++) {
+        pad[i] ^= 0x36;
+    }
+    memset(pad + n, 0x36, 64 - n);
+
+    sha256_init(&st->sha256);
+    sha256_update(&st->sha256, pad, 64);
+    sha256_update(&st->sha256, opt_rand, n);
+}
+
+void sha256_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    unsigned i;
+    sha256_t sha2;
+    uint8_t pad[64], buf[32];
+    size_t  n = ctx->prm->n;
+
+    sha256_final(&st->sha256, buf);
+
+    //  opad
+    memcpy(pad, ctx->sk_prf, n);
+    for (i = 0; i < n; i++) {
+        pad[i] ^= 0x5C;
+    }
+    memset(pad + n, 0x5C, 64 - n);
+
+    sha256_init(&sha2);
+    sha256_update(&sha2, pad, 64);
+    sha256_update(&sha2, buf, 32);
+    sha256_final_len(&sha2, h, n);
+}
+
+void sha256_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz)
+{
+    sha256_update(&st->sha256, m, m_sz);
+}
+
+//  one-shot versions for the parameter set tables
+
+void sha2_256_h_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    sha2_256_h_msg_init(ctx, &st, r);
+    sha256_msg_update(&st, m, m_sz);
+    sha2_256_h_msg_final(ctx, &st, h, r);
+}
+
+void sha256_prf_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    sha256_prf_msg_init(ctx, &st, opt_rand);
+    sha256_msg_update(&st, m, m_sz);
+    sha256_prf_msg_final(ctx, &st, h);
+}
+
+//  === 10.3.   SLH-DSA Using SHA2 for Security Categories 3 and 5
+
+//  Cat 3, 5: Hmsg(R, PK.seed, PK.root, M) =
+//      MGF1-SHA-512(R || PK.seed || SHA-512(R || PK.seed || PK.root || M), m)
+
+void sha2_512_h_msg_init(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r)
+{
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_H_MSG, NULL, 1);
+
+    sha512_init(&st->sha512);
+    sha512_update(&st->sha512, r, n);
+    sha512_update(&st->sha512, ctx->pk_seed, n);
+    sha512_update(&st->sha512, ctx->pk_root, n);
+}
+
+void sha2_512_h_msg_final(  slh_ctx_t *ctx, slh_msg_t *st,
+                            uint8_t *h, const uint8_t *r)
+{
+    sha512_t sha2;
+    uint8_t mgf[32 + 32 + 64 + 4];
+    size_t  n = ctx->prm->n;
+
+    //  MGF1-SHA-512(R || PK.seed || ..
+    memcpy(mgf, r, n);
+    memcpy(mgf + n, ctx->pk_seed, n);
+    sha512_final(&st->sha512, mgf + 2 * n);
+
+    size_t mgf_sz = 2 * n + 64 + 4;
+    uint8_t *ctr = mgf + mgf_sz - 4;
+
+    //  MGF1 counter mode
+    for (size_t i = 0; i < ctx->prm->m; i += 64) {
+        uint32_t c = i / 64;
+        ctr[0] = c >> 24;
+        ctr[1] = (c >> 16) & 0xFF;
+        ctr[2] = (c >> 8) & 0xFF;
+        ctr[3] = c & 0xFF;
+
+        sha512_init(&sha2);
+        sha512_update(&sha2, mgf, mgf_sz);
+        if ((ctx->prm->m - i) >= 64) {
+            sha512_final(&sha2, h + i);
+        } else {
+            sha512_final(&sha2, mgf);
+            memcpy(h + i, mgf, ctx->prm->m - i);
+        }
+    }
+}
+
+//  Cat 3, 5: PRFmsg(SK.prf, opt_rand, M) =
+//      Trunc_n(HMAC-SHA-512(SK.prf, opt_rand || M))
+
+void sha512_prf_msg_init(   slh_ctx_t *ctx, slh_msg_t *st,
+                            const uint8_t *opt_rand)
+{
+    unsigned i;
+    uint8_t pad[128];
+    size_t  n = ctx->prm->n;
+
+    SLH_COUNT_HASH(SLH_CNT_PRF_MSG, NULL, 1);
+
+    //  ipad
+    memcpy(pad, ctx->sk_prf, n);
+    for (i = 0; i < n; i++) {
+        pad[i] ^= 0x36;
+    }
+    memset(pad + n, 0x36, 128 - n);
+
+    sha512_init(&st->sha512);
+    sha512_update(&st->sha512, pad, 128);
+    sha512_update(&st->sha512, opt_rand, n);
+}
+
+void sha512_prf_msg_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    unsigned i;
+    sha512_t sha2;
+    uint8_t pad[128], buf[64];
+    size_t  n = ctx->prm->n;
+
+    sha512_final(&st->sha512, buf);
+
+    //  opad
+    memcpy(pad, ctx->sk_prf, n);
+    for (i = 0; i < n; i++) {
+        pad[i] ^= 0x5C;
+    }
+    memset(pad + n, 0x5C, 128 - n);
+
+    sha512_init(&sha2);
+    sha512_update(&sha2, pad, 128);
+    sha512_update(&sha2, buf, 64);
+    sha512_final_len(&sha2, h, n);
+}
+
+void sha512_msg_update(slh_msg_t *st, const uint8_t *m, size_t m_sz)
+{
+    sha512_update(&st->sha512, m, m_sz);
+}
+
+//  one-shot versions for the parameter set tables
+
+void sha2_512_h_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *r,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    sha2_512_h_msg_init(ctx, &st, r);
+    sha512_msg_update(&st, m, m_sz);
+    sha2_512_h_msg_final(ctx, &st, h, r);
+}
+
+void sha512_prf_msg(slh_ctx_t *ctx, uint8_t *h, const uint8_t *opt_rand,
+                    const uint8_t *m, size_t m_sz)
+{
+    slh_msg_t st;
+
+    sha512_prf_msg_init(ctx, &st, opt_rand);
+    sha512_msg_update(&st, m, m_sz);
+    sha512_prf_msg_final(ctx, &st, h);
+}
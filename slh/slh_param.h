@@ -18,6 +18,17 @@ typedef union {
 //  Parameter sets
 typedef struct slh_param_s  slh_param_t;
 typedef struct slh_ctx_s    slh_ctx_t;
+typedef union  slh_msg_u    slh_msg_t;
+
+//  One lane of a multi-buffer hash call
+
+typedef struct {
+    slh_ctx_t       *ctx;       //  key material (PK.seed, SK.seed, ..)
+    adrs_t          adrs;       //  address for this lane
+    uint8_t         *h;         //  n-byte output
+    const uint8_t   *m1;        //  n-byte input(s)
+    const uint8_t   *m2;
+} slh_lane_t;
 
 struct slh_param_s {
     const char  *alg_id;    //  Algorithm name
@@ -49,7 +60,38 @@ struct slh_param_s {
                                 const uint8_t *m1, const uint8_t *m2);
     void (*h_t)(slh_ctx_t *ctx, uint8_t *h,
                                 const uint8_t *m, size_t m_sz);
+
+    //  incremental h_msg() and prf_msg(): init, msg_update() any number of
+    //  times, then final
+    void (*h_msg_init)(slh_ctx_t *ctx, slh_msg_t *st, const uint8_t *r);
+    void (*h_msg_final)(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h,
+                                        const uint8_t *r);
+    void (*prf_msg_init)(slh_ctx_t *ctx,    slh_msg_t *st,
+                                            const uint8_t *opt_rand);
+    void (*prf_msg_final)(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h);
+    void (*msg_update)(slh_msg_t *st, const uint8_t *m, size_t m_sz);
+
+    //  incremental h_t() (optional; NULL): init with the current ADRS,
+    //  msg_update() with each n-byte value, then final
+    void (*h_t_init)(slh_ctx_t *ctx, slh_msg_t *st);
+    void (*h_t_final)(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h);
+
+    //  multi-buffer versions for l independent lanes (optional; NULL)
+    //  chain_x() is only used together with h_t_init()
+    void (*prf_x)(slh_lane_t *lane, uint32_t l);
+    void (*h_f_x)(slh_lane_t *lane, uint32_t l);
+    void (*h_h_x)(slh_lane_t *lane, uint32_t l);
+    void (*chain_x)(slh_lane_t *lane, uint32_t l, uint32_t s);
 };
 
+//  Multi-buffer entries of the parameter sets. "make NOX=1" (SLH_NO_X)
+//  leaves them NULL so that the tests cover the scalar code paths.
+
+#ifdef SLH_NO_X
+#define SLH_X(f) (0 ? (f) : NULL)
+#else
+#define SLH_X(f) (f)
+#endif
+
 //  _SLH_PARAM_H_
 #endif
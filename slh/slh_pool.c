@@ -0,0 +1,170 @@
+//  slh_pool.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === A minimal built-in POSIX threads pool for the slh_par_t interface.
+
+#ifndef SLOTH
+
+#include "slh_dsa.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+//  pool state; the first member makes (slh_par_t *) == (slh_pool_t *)
+
+typedef struct {
+    slh_par_t       par;                    //  public interface
+    pthread_mutex_t mtx;
+    pthread_cond_t  go;                     //  signaled on a new job
+    pthread_cond_t  done;                   //  signaled when job complete
+    pthread_t       *thr;                   //  worker threads
+    uint32_t        threads;                //  number of worker threads
+    bool            stop;                   //  shut down
+    bool            busy;                   //  a job is active
+
+    //  current job
+    void            (*fn)(void *arg, uint32_t i);
+    void            *arg;
+    uint32_t        n;                      //  number of items
+    uint32_t        next;                   //  next unclaimed item
+    uint32_t        left;                   //  items not yet completed
+    uint64_t        gen;                    //  job generation counter
+} slh_pool_t;
+
+//  claim and process items until the job runs out (called with mtx held)
+
+static void pool_drain(slh_pool_t *pool)
+{
+    uint32_t i;
+
+    while (pool->next < pool->n) {
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->mtx);
+        pool->fn(pool->arg, i);
+        pthread_mutex_lock(&pool->mtx);
+        if (--pool->left == 0) {
+            pthread_cond_broadcast(&pool->done);
+        }
+    }
+}
+
+//  worker thread main loop
+
+static void *pool_worker(void *arg)
+{
+    slh_pool_t *pool = (slh_pool_t *) arg;
+    uint64_t gen = 0;
+
+    pthread_mutex_lock(&pool->mtx);
+    while (1) {
+        while (!pool->stop && pool->gen == gen) {
+            pthread_cond_wait(&pool->go, &pool->mtx);
+        }
+        if (pool->stop)
+            break;
+        gen = pool->gen;
+        pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->mtx);
+
+    return NULL;
+}
+
+//  slh_par_t callback: run fn(arg, i) for i = 0 .. n - 1
+
+static void pool_par_for(   void *p, void (*fn)(void *arg, uint32_t i),
+                            void *arg, uint32_t n)
+{
+    slh_pool_t *pool = (slh_pool_t *) p;
+    uint32_t i;
+
+    pthread_mutex_lock(&pool->mtx);
+
+    //  nested or concurrent use: just run it in the calling thread
+    if (pool->busy) {
+        pthread_mutex_unlock(&pool->mtx);
+        for (i = 0; i < n; i++) {
+            fn(arg, i);
+        }
+        return;
+    }
+
+    pool->busy  = true;
+    pool->fn    = fn;
+    pool->arg   = arg;
+    pool->n     = n;
+    pool->next  = 0;
+    pool->left  = n;
+    pool->gen++;
+    pthread_cond_broadcast(&pool->go);
+
+    //  the caller works too
+    pool_drain(pool);
+    while (pool->left > 0) {
+        pthread_cond_wait(&pool->done, &pool->mtx);
+    }
+    pool->busy  = false;
+
+    pthread_mutex_unlock(&pool->mtx);
+}
+
+//  Create a built-in pool of "threads" threads (including the caller.)
+
+slh_par_t *slh_pool_new(uint32_t threads)
+{
+    slh_pool_t *pool;
+    uint32_t i;
+
+    pool = (slh_pool_t *) calloc(1, sizeof(slh_pool_t));
+    if (pool == NULL)
+        return NULL;
+
+    pool->par.par_for   = pool_par_for;
+    pool->par.pool      = pool;
+
+    pool->thr = (pthread_t *) calloc(threads + 1, sizeof(pthread_t));
+    if (pool->thr == NULL) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->mtx, NULL);
+    pthread_cond_init(&pool->go, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (i = 0; i + 1 < threads; i++) {
+        if (pthread_create(&pool->thr[i], NULL, pool_worker, pool) != 0) {
+            break;
+        }
+        pool->threads++;
+    }
+    pool->par.threads   = pool->threads + 1;    //  caller participates
+
+    return &pool->par;
+}
+
+//  Stop the workers and free a pool created with slh_pool_new().
+
+void slh_pool_free(slh_par_t *par)
+{
+    slh_pool_t *pool = (slh_pool_t *) par;
+    uint32_t i;
+
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->mtx);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->go);
+    pthread_mutex_unlock(&pool->mtx);
+
+    for (i = 0; i < pool->threads; i++) {
+        pthread_join(pool->thr[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->go);
+    pthread_mutex_destroy(&pool->mtx);
+    free(pool->thr);
+    free(pool);
+}
+
+//  SLOTH
+#endif
@@ -0,0 +1,191 @@
+//  slh_prehash.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Pure SLH-DSA with a context string and pre-hash SLH-DSA (HashSLH-DSA)
+//  signing and verification; the message framing of the final FIPS 205.
+
+#include "slh_dsa.h"
+#include "sha2_api.h"
+#include "sha3_api.h"
+#include "slh_count.h"
+#include <string.h>
+
+//  M' = toByte(0, 1) || toByte(|ctx|, 1) || ctx || M, read in pieces by
+//  slh_sign_read() and slh_verify_read() so that M is not copied
+
+typedef struct {
+    uint8_t         pre[2 + 255];
+    size_t          pre_sz;
+    const uint8_t   *m;
+    size_t          m_sz;
+} pure_msg_t;
+
+static size_t pure_read(void *arg, uint8_t *buf, size_t sz, uint64_t pos)
+{
+    const pure_msg_t *pm = (const pure_msg_t *) arg;
+    size_t  l = 0, k;
+
+    if (pos < pm->pre_sz) {
+        l = pm->pre_sz - (size_t) pos;
+        l = l < sz ? l : sz;
+        memcpy(buf, pm->pre + pos, l);
+        pos += l;
+    }
+    if (l < sz && pos < pm->pre_sz + pm->m_sz) {
+        k = pm->pre_sz + pm->m_sz - (size_t) pos;
+        k = k < sz - l ? k : sz - l;
+        memcpy(buf + l, pm->m + (pos - pm->pre_sz), k);
+        l += k;
+    }
+    return l;
+}
+
+static bool pure_msg(   pure_msg_t *pm, const uint8_t *m, size_t m_sz,
+                        const uint8_t *ctx, size_t ctx_sz)
+{
+    if (ctx_sz > 255)
+        return false;
+
+    pm->pre[0] = 0;
+    pm->pre[1] = (uint8_t) ctx_sz;
+    memcpy(pm->pre + 2, ctx, ctx_sz);
+    pm->pre_sz = 2 + ctx_sz;
+    pm->m = m;
+    pm->m_sz = m_sz;
+
+    return true;
+}
+
+size_t slh_pure_sign(   uint8_t *sig, const uint8_t *m, size_t m_sz,
+                        const uint8_t *ctx, size_t ctx_sz,
+                        const uint8_t *sk,
+                        int (*rbg)(uint8_t *x, size_t xlen),
+                        const slh_param_t *prm)
+{
+    pure_msg_t pm;
+
+    if (!pure_msg(&pm, m, m_sz, ctx, ctx_sz))
+        return 0;
+
+    return slh_sign_read(sig, pure_read, &pm, sk, rbg, prm);
+}
+
+bool slh_pure_verify(   const uint8_t *m, size_t m_sz,
+                        const uint8_t *ctx, size_t ctx_sz,
+                        const uint8_t *sig, const uint8_t *pk,
+                        const slh_param_t *prm)
+{
+    pure_msg_t pm;
+
+    if (!pure_msg(&pm, m, m_sz, ctx, ctx_sz))
+        return false;
+
+    return slh_verify_read(pure_read, &pm, sig, pk, prm);
+}
+
+//  DER encoded OIDs 2.16.840.1.101.3.4.2.x of the pre-hash functions
+
+#define PH_OID_SZ 11
+
+static const uint8_t ph_oid[4][PH_OID_SZ] = {
+    {   0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01 },
+    {   0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03 },
+    {   0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x0B },
+    {   0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x0C }
+};
+
+//  digest sizes
+static const size_t ph_sz[4] = { 32, 64, 32, 64 };
+
+//  Return the size of the digest of pre-hash function ph, or 0.
+
+size_t slh_ph_sz(int ph)
+{
+    if (ph < SLH_PH_SHA2_256 || ph > SLH_PH_SHAKE256)
+        return 0;
+    return ph_sz[ph - SLH_PH_SHA2_256];
+}
+
+//  Compute the digest ph_m of message m with pre-hash function ph.
+
+size_t slh_ph_digest(uint8_t *ph_m, const uint8_t *m, size_t m_sz, int ph)
+{
+    sha3_ctx_t sha3;
+
+    SLH_COUNT_HASH(SLH_CNT_F, NULL, 0);     //  not keyed by an ADRS
+    switch (ph) {
+
+        case SLH_PH_SHA2_256:
+            sha2_256(ph_m, m, m_sz);
+            break;
+
+        case SLH_PH_SHA2_512:
+            sha2_512(ph_m, m, m_sz);
+            break;
+
+        case SLH_PH_SHAKE128:
+            shake128_init(&sha3);
+            shake_update(&sha3, m, m_sz);
+            shake_out(&sha3, ph_m, 32);
+            break;
+
+        case SLH_PH_SHAKE256:
+            shake256_init(&sha3);
+            shake_update(&sha3, m, m_sz);
+            shake_out(&sha3, ph_m, 64);
+            break;
+
+        default:
+            return 0;
+    }
+    return slh_ph_sz(ph);
+}
+
+//  M' = toByte(1, 1) || toByte(|ctx|, 1) || ctx || OID || PH(M)
+
+static size_t ph_msg(   uint8_t *mp, const uint8_t *ph_m, int ph,
+                        const uint8_t *ctx, size_t ctx_sz)
+{
+    size_t  l = slh_ph_sz(ph);
+
+    if (l == 0 || ctx_sz > 255)
+        return 0;
+
+    mp[0] = 1;
+    mp[1] = (uint8_t) ctx_sz;
+    memcpy(mp + 2, ctx, ctx_sz);
+    memcpy(mp + 2 + ctx_sz, ph_oid[ph - SLH_PH_SHA2_256], PH_OID_SZ);
+    memcpy(mp + 2 + ctx_sz + PH_OID_SZ, ph_m, l);
+
+    return 2 + ctx_sz + PH_OID_SZ + l;
+}
+
+size_t slh_ph_sign( uint8_t *sig, const uint8_t *ph_m, int ph,
+                    const uint8_t *ctx, size_t ctx_sz,
+                    const uint8_t *sk, int (*rbg)(uint8_t *x, size_t xlen),
+                    const slh_param_t *prm)
+{
+    uint8_t mp[2 + 255 + PH_OID_SZ + 64];
+    size_t  mp_sz;
+
+    mp_sz = ph_msg(mp, ph_m, ph, ctx, ctx_sz);
+    if (mp_sz == 0)
+        return 0;
+
+    return slh_sign(sig, mp, mp_sz, sk, rbg, prm);
+}
+
+bool slh_ph_verify( const uint8_t *ph_m, int ph,
+                    const uint8_t *ctx, size_t ctx_sz,
+                    const uint8_t *sig, const uint8_t *pk,
+                    const slh_param_t *prm)
+{
+    uint8_t mp[2 + 255 + PH_OID_SZ + 64];
+    size_t  mp_sz;
+
+    mp_sz = ph_msg(mp, ph_m, ph, ctx, ctx_sz);
+    if (mp_sz == 0)
+        return false;
+
+    return slh_verify(mp, mp_sz, sig, pk, prm);
+}
@@ -7,99 +7,12 @@
 
 #include "plat_local.h"
 #include "sha2_api.h"
+#include "hash_cpu.h"
 #include "slh_ctx.h"
 #include "slh_adrs.h"
+#include "slh_count.h"
 #include <string.h>
 
-//  Cat 1: Hmsg(R, PK.seed, PK.root, M) =
-//      MGF1-SHA-256(R || PK.seed || SHA-256(R ||PK.seed || PK.root || M), m)
-
-static void sha2_256_h_msg( slh_ctx_t *ctx, uint8_t *h,
-                            const uint8_t *r, const uint8_t *m, size_t m_sz)
-{
-    sha256_t sha2;
-    uint8_t mgf[16 + 16 + 32 + 4];
-    size_t  n = ctx->prm->n;
-
-    //  MGF1-SHA-256(R || PK.seed || ..
-    memcpy(mgf, r, n);
-    memcpy(mgf + n, ctx->pk_seed, n);
-
-    //  SHA-256(R || PK.seed || PK.root || M)
-    sha256_init(&sha2);
-    sha256_update(&sha2, r, n);
-    sha256_update(&sha2, ctx->pk_seed, n);
-    sha256_update(&sha2, ctx->pk_root, n);
-    sha256_update(&sha2, m, m_sz);
-    sha256_final(&sha2, mgf + 2 * n);
-
-    size_t mgf_sz = 2 * n + 32 + 4;
-    uint8_t *ctr = mgf + mgf_sz - 4;
-
-    //  MGF1 counter mode
-    for (size_t i = 0; i < ctx->prm->m; i += 32) {
-        uint32_t c = i / 32;
-        ctr[0] = c >> 24;
-        ctr[1] = (c >> 16) & 0xFF;
-        ctr[2] = (c >> 8) & 0xFF;
-        ctr[3] = c & 0xFF;
-
-        sha256_init(&sha2);
-        sha256_update(&sha2, mgf, mgf_sz);
-        if ((ctx->prm->m - i) >= 32) {
-            sha256_final(&sha2, h + i);
-        } else {
-            sha256_final(&sha2, mgf);
-            memcpy(h + i, mgf, ctx->prm->m - i);
-        }
-    }
-
-}
-
-//  Cat 3, 5: Hmsg(R, PK.seed, PK.root, M) =
-//      MGF1-SHA-512(R || PK.seed || SHA-512(R || PK.seed || PK.root || M), m)
-
-static void sha2_512_h_msg( slh_ctx_t *ctx, uint8_t *h,
-                            const uint8_t *r, const uint8_t *m, size_t m_sz)
-{
-    sha512_t sha2;
-    uint8_t mgf[32 + 32 + 64 + 4];
-    size_t  n = ctx->prm->n;
-
-    //  MGF1-SHA-512(R || PK.seed || ..
-    memcpy(mgf, r, n);
-    memcpy(mgf + n, ctx->pk_seed, n);
-
-    //  SHA-512(R || PK.seed || PK.root || M)
-    sha512_init(&sha2);
-    sha512_update(&sha2, r, n);
-    sha512_update(&sha2, ctx->pk_seed, n);
-    sha512_update(&sha2, ctx->pk_root, n);
-    sha512_update(&sha2, m, m_sz);
-    sha512_final(&sha2, mgf + 2 * n);
-
-    size_t mgf_sz = 2 * n + 64 + 4;
-    uint8_t *ctr = mgf + mgf_sz - 4;
-
-    //  MGF1 counter mode
-    for (size_t i = 0; i < ctx->prm->m; i += 64) {
-        uint32_t c = i / 64;
-        ctr[0] = c >> 24;
-        ctr[1] = (c >> 16) & 0xFF;
-        ctr[2] = (c >> 8) & 0xFF;
-        ctr[3] = c & 0xFF;
-
-        sha512_init(&sha2);
-        sha512_update(&sha2, mgf, mgf_sz);
-        if ((ctx->prm->m - i) >= 64) {
-            sha512_final(&sha2, h + i);
-        } else {
-            sha512_final(&sha2, mgf);
-            memcpy(h + i, mgf, ctx->prm->m - i);
-        }
-    }
-}
-
 //  insert ARDSc.
 
 static void sha256_adrsc(sha256_t *sha2, const slh_ctx_t *ctx)
@@ -125,6 +38,7 @@ static void sha256_prf( slh_ctx_t *ctx,
     sha256_t sha2;
     size_t  n = ctx->prm->n;
 
+    SLH_COUNT_HASH(SLH_CNT_PRF, ctx->adrs, 1);
     sha256_copy(&sha2, &ctx->sha256_pk_seed);
     sha256_adrsc(&sha2, ctx);
     sha256_update(&sha2, ctx->sk_seed, n);
@@ -133,93 +47,42 @@ static void sha256_prf( slh_ctx_t *ctx,
     memcpy(h, sha2.s, n);
 }
 
-//  Cat 1: PRFmsg(SK.prf, opt_rand, M) =
-//      Trunc_n(HMAC-SHA-256(SK.prf, opt_rand || M))
+//  Cat 1: T_l(PK.seed, ADRS, M1 ) =
+//      Trunc_n(SHA-256(PK.seed || toByte(0, 64 − n) || ADRSc || Ml ))
 
-static void sha256_prf_msg( slh_ctx_t *ctx,
+static void sha256_tl_do(   slh_ctx_t *ctx,
                             uint8_t *h,
-                            const uint8_t *opt_rand,
                             const uint8_t *m, size_t m_sz)
 {
-    unsigned i;
     sha256_t sha2;
-    uint8_t pad[64], buf[32];
     size_t  n = ctx->prm->n;
 
-    //  ipad
-    memcpy(pad, ctx->sk_prf, n);
-    for (i = 0; i < n; i++) {
-        pad[i] ^= 0x36;
-    }
-    memset(pad + n, 0x36, 64 - n);
-
-    sha256_init(&sha2);
-    sha256_update(&sha2, pad, 64);
-    sha256_update(&sha2, opt_rand, n);
+    sha256_copy(&sha2, &ctx->sha256_pk_seed);
+    sha256_adrsc(&sha2, ctx);
     sha256_update(&sha2, m, m_sz);
-    sha256_final(&sha2, buf);
-
-    //  opad
-    for (i = 0; i < 64; i++) {
-        pad[i] ^= 0x36 ^ 0x5C;
-    }
-
-    sha256_init(&sha2);
-    sha256_update(&sha2, pad, 64);
-    sha256_update(&sha2, buf, 32);
     sha256_final_len(&sha2, h, n);
 }
 
-//  Cat 3, 5: PRFmsg(SK.prf, opt_rand, M) =
-//      Trunc_n(HMAC-SHA-512(SK.prf, opt_rand || M))
-
-static void sha512_prf_msg( slh_ctx_t *ctx,
-                            uint8_t *h, const uint8_t *opt_rand,
-                            const uint8_t *m, size_t m_sz)
+static void sha256_tl( slh_ctx_t *ctx,
+                        uint8_t *h,
+                        const uint8_t *m, size_t m_sz)
 {
-    unsigned i;
-    sha512_t sha2;
-    uint8_t pad[128], buf[64];
-    size_t  n = ctx->prm->n;
-
-    //  ipad
-    memcpy(pad, ctx->sk_prf, n);
-    for (i = 0; i < n; i++) {
-        pad[i] ^= 0x36;
-    }
-    memset(pad + n, 0x36, 128 - n);
-
-    sha512_init(&sha2);
-    sha512_update(&sha2, pad, 128);
-    sha512_update(&sha2, opt_rand, n);
-    sha512_update(&sha2, m, m_sz);
-    sha512_final(&sha2, buf);
-
-    //  opad
-    for (i = 0; i < 128; i++) {
-        pad[i] ^= 0x36 ^ 0x5C;
-    }
-
-    sha512_init(&sha2);
-    sha512_update(&sha2, pad, 128);
-    sha512_update(&sha2, buf, 64);
-    sha512_final_len(&sha2, h, n);
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
+    sha256_tl_do(ctx, h, m, m_sz);
 }
 
-//  Cat 1: T_l(PK.seed, ADRS, M1 ) =
-//      Trunc_n(SHA-256(PK.seed || toByte(0, 64 − n) || ADRSc || Ml ))
+//  Cat 1: incremental T_l, the values via msg_update()
 
-static void sha256_tl( slh_ctx_t *ctx,
-                        uint8_t *h,
-                        const uint8_t *m, size_t m_sz)
+static void sha256_tl_init(slh_ctx_t *ctx, slh_msg_t *st)
 {
-    sha256_t sha2;
-    size_t  n = ctx->prm->n;
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
+    sha256_copy(&st->sha256, &ctx->sha256_pk_seed);
+    sha256_adrsc(&st->sha256, ctx);
+}
 
-    sha256_copy(&sha2, &ctx->sha256_pk_seed);
-    sha256_adrsc(&sha2, ctx);
-    sha256_update(&sha2, m, m_sz);
-    sha256_final_len(&sha2, h, n);
+static void sha256_tl_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    sha256_final_len(&st->sha256, h, ctx->prm->n);
 }
 
 //  Cat 1: F(PK.seed, ADRS, M1 ) =
@@ -228,7 +91,8 @@ static void sha256_tl( slh_ctx_t *ctx,
 static void sha256_f( slh_ctx_t *ctx,
                         uint8_t *h, const uint8_t *m1)
 {
-    sha256_tl(ctx, h, m1, ctx->prm->n);
+    SLH_COUNT_HASH(SLH_CNT_F, ctx->adrs, 1);
+    sha256_tl_do(ctx, h, m1, ctx->prm->n);
 }
 
 //  Cat 1: H(PK.seed, ADRS, M2 ) =
@@ -241,6 +105,7 @@ static void sha256_h( slh_ctx_t *ctx,
     sha256_t sha2;
     size_t  n = ctx->prm->n;
 
+    SLH_COUNT_HASH(SLH_CNT_H, ctx->adrs, 1);
     sha256_copy(&sha2, &ctx->sha256_pk_seed);
     sha256_adrsc(&sha2, ctx);
     sha256_update(&sha2, m1, n);
@@ -258,12 +123,27 @@ static void sha512_tl( slh_ctx_t *ctx,
     sha512_t sha2;
     size_t  n = ctx->prm->n;
 
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
     sha512_copy(&sha2, &ctx->sha512_pk_seed);
     sha512_adrsc(&sha2, ctx);
     sha512_update(&sha2, m, m_sz);
     sha512_final_len(&sha2, h, n);
 }
 
+//  Cat 3, 5: incremental T_l, the values via msg_update()
+
+static void sha512_tl_init(slh_ctx_t *ctx, slh_msg_t *st)
+{
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
+    sha512_copy(&st->sha512, &ctx->sha512_pk_seed);
+    sha512_adrsc(&st->sha512, ctx);
+}
+
+static void sha512_tl_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    sha512_final_len(&st->sha512, h, ctx->prm->n);
+}
+
 //  Cat 3, 5: H(PK.seed, ADRS, M2 ) =
 //      Trunc_n(SHA-512(PK.seed || toByte(0, 128 − n) || ADRSc || M2 ))
 
@@ -274,6 +154,7 @@ static void sha512_h( slh_ctx_t *ctx,
     sha512_t sha2;
     size_t  n = ctx->prm->n;
 
+    SLH_COUNT_HASH(SLH_CNT_H, ctx->adrs, 1);
     sha512_copy(&sha2, &ctx->sha512_pk_seed);
     sha512_adrsc(&sha2, ctx);
     sha512_update(&sha2, m1, n);
@@ -301,7 +182,8 @@ static void sha2_mk_ctx(slh_ctx_t *ctx,
         memcpy( ctx->pk_root,   pk + n,     n );
     }
 
-    //  eliminate the first compression function
+    //  eliminate the first compression function (not keyed by an ADRS)
+    SLH_COUNT_HASH(SLH_CNT_F, NULL, 0);
     uint8_t buf[128-24];
     memset(buf, 0x00, sizeof(buf));
     sha256_init(&ctx->sha256_pk_seed);
@@ -339,6 +221,7 @@ static void sha256_chain(   slh_ctx_t *ctx, uint8_t *tmp, const uint8_t *x,
 
     //  set initial address
     adrs_set_hash_address(ctx, i);
+    SLH_COUNT_HASH(SLH_CNT_F, ctx->adrs, s);
 
     //  initial set-up
     sha256_copy(&sha2, &ctx->sha256_pk_seed);
@@ -397,6 +280,214 @@ static void sha256_fors_hash( slh_ctx_t *ctx, uint8_t *tmp, uint32_t s)
     }
 }
 
+//  === Multi-buffer functions with sha256_compress_x8() / _x16()
+
+//  The number of lanes xn (8 or 16) is selected at runtime, see hash_cpu.c;
+//  word k of lane j is at v[k * xn + j].
+
+#define SHA256_XN 16                        //  maximum number of lanes
+
+static void sha256_compress_xn(uint32_t *v, uint32_t xn)
+{
+    if (xn == 16) {
+        sha256_compress_x16(v);
+    } else {
+        sha256_compress_x8(v);
+    }
+}
+
+//  second block of SHA-256(PK.seed || toByte(0, 64 - n) || ADRSc || M)
+//  where M = M1 || M2 (or just M1 if M2 == NULL)
+
+static void sha256_x_block( uint8_t *blk, const slh_lane_t *lane,
+                            const uint8_t *m1, const uint8_t *m2)
+{
+    size_t  n = lane->ctx->prm->n;
+    size_t  l, x;
+
+    lane_adrsc_22(lane, blk);
+    memcpy(blk + 22, m1, n);
+    l = 22 + n;
+    if (m2 != NULL) {
+        memcpy(blk + l, m2, n);
+        l += n;
+    }
+    blk[l++] = 0x80;                        //  padding
+    memset(blk + l, 0x00, 64 - l);
+    x = (64 + l - 1) * 8;                   //  bit length
+    blk[62] = x >> 8;
+    blk[63] = x & 0xFF;
+}
+
+//  load lane j of the multi-buffer state: midstate and a message block
+
+static void sha256_x_load(  uint32_t *v, uint32_t xn, uint32_t j,
+                            const slh_ctx_t *ctx, const uint8_t *blk)
+{
+    uint32_t k, w[24];
+
+    memcpy(w, ctx->sha256_pk_seed.s, 32);
+    memcpy(w + 8, blk, 64);
+    for (k = 0; k < 24; k++) {
+        v[k * xn + j] = w[k];
+    }
+}
+
+//  get n-byte output of lane j
+
+static void sha256_x_out(   uint8_t *h, const uint32_t *v, uint32_t xn,
+                            uint32_t j, size_t n)
+{
+    uint32_t k, w[8];
+
+    for (k = 0; k < 8; k++) {
+        w[k] = v[k * xn + j];
+    }
+    memcpy(h, w, n);
+}
+
+//  F, H, or PRF for l lanes. Unused lanes in the last group repeat lane 0.
+
+static void sha256_fh_x(slh_lane_t *lane, uint32_t l, bool prf, bool hh)
+{
+    uint32_t i, j, q;
+    uint32_t v[24 * SHA256_XN];
+    uint32_t xn = hash_cpu.sha256_xn;
+    uint8_t blk[64];
+    slh_lane_t *p;
+
+    for (i = 0; i < l; i++) {
+        SLH_COUNT_HASH(prf ? SLH_CNT_PRF : hh ? SLH_CNT_H : SLH_CNT_F,
+                        &lane[i].adrs, 1);
+    }
+
+    for (i = 0; i < l; i += xn) {
+        q = l - i < xn ? l - i : xn;
+        for (j = 0; j < xn; j++) {
+            p = &lane[i + (j < q ? j : 0)];
+            sha256_x_block( blk, p, prf ? p->ctx->sk_seed : p->m1,
+                            hh ? p->m2 : NULL);
+            sha256_x_load(v, xn, j, p->ctx, blk);
+        }
+        sha256_compress_xn(v, xn);
+        for (j = 0; j < q; j++) {
+            p = &lane[i + j];
+            sha256_x_out(p->h, v, xn, j, p->ctx->prm->n);
+        }
+    }
+}
+
+static void sha256_prf_x(slh_lane_t *lane, uint32_t l)
+{
+    sha256_fh_x(lane, l, true, false);
+}
+
+static void sha256_f_x(slh_lane_t *lane, uint32_t l)
+{
+    sha256_fh_x(lane, l, false, false);
+}
+
+static void sha256_h_x(slh_lane_t *lane, uint32_t l)
+{
+    sha256_fh_x(lane, l, false, true);
+}
+
+//  s chaining steps for l lanes, starting from the hash address of each
+
+static void sha256_chain_x(slh_lane_t *lane, uint32_t l, uint32_t s)
+{
+    uint32_t i, j, k, q;
+    uint32_t v[24 * SHA256_XN];
+    uint32_t xn = hash_cpu.sha256_xn;
+    uint8_t blk[SHA256_XN][64];
+    uint32_t a0[SHA256_XN];
+    slh_lane_t *p;
+
+    for (i = 0; i < l; i++) {
+        SLH_COUNT_HASH(SLH_CNT_F, &lane[i].adrs, s);
+    }
+
+    for (i = 0; i < l; i += xn) {
+        q = l - i < xn ? l - i : xn;
+        for (j = 0; j < xn; j++) {
+            p = &lane[i + (j < q ? j : 0)];
+            sha256_x_block(blk[j], p, p->m1, NULL);
+            a0[j] = lane_get_hash_address(p);
+        }
+        for (k = 0; k < s; k++) {
+            for (j = 0; j < xn; j++) {
+                p = &lane[i + (j < q ? j : 0)];
+                slh_tobyte(blk[j] + 18, a0[j] + k, 4);  //  hash address
+                sha256_x_load(v, xn, j, p->ctx, blk[j]);
+            }
+            sha256_compress_xn(v, xn);
+            for (j = 0; j < xn; j++) {
+                p = &lane[i + (j < q ? j : 0)];
+                sha256_x_out(blk[j] + 22, v, xn, j, p->ctx->prm->n);
+            }
+        }
+        for (j = 0; j < q; j++) {
+            p = &lane[i + j];
+            memcpy(p->h, blk[j] + 22, p->ctx->prm->n);
+        }
+    }
+}
+
+//  === Multi-buffer H with sha512_compress_x4() / _x8() (Cat 3, 5)
+
+#define SHA512_XN 8                         //  maximum number of lanes
+
+//  H for l lanes; second block of
+//  SHA-512(PK.seed || toByte(0, 128 - n) || ADRSc || M1 || M2)
+
+static void sha512_h_x(slh_lane_t *lane, uint32_t l)
+{
+    uint32_t i, j, k, q;
+    uint64_t v[24 * SHA512_XN];
+    uint32_t xn = hash_cpu.sha512_xn;
+    uint64_t w[24];
+    uint8_t *blk = (uint8_t *) &w[8];
+    slh_lane_t *p;
+    size_t  n, x;
+
+    for (i = 0; i < l; i++) {
+        SLH_COUNT_HASH(SLH_CNT_H, &lane[i].adrs, 1);
+    }
+
+    for (i = 0; i < l; i += xn) {
+        q = l - i < xn ? l - i : xn;
+        for (j = 0; j < xn; j++) {
+            p = &lane[i + (j < q ? j : 0)];
+            n = p->ctx->prm->n;
+            memcpy(w, p->ctx->sha512_pk_seed.s, 64);
+            lane_adrsc_22(p, blk);
+            memcpy(blk + 22, p->m1, n);
+            memcpy(blk + 22 + n, p->m2, n);
+            x = 22 + 2 * n;
+            blk[x] = 0x80;                  //  padding
+            memset(blk + x + 1, 0x00, 128 - x - 1);
+            x = (128 + x) * 8;              //  bit length
+            blk[126] = x >> 8;
+            blk[127] = x & 0xFF;
+            for (k = 0; k < 24; k++) {
+                v[k * xn + j] = w[k];
+            }
+        }
+        if (xn == 8) {
+            sha512_compress_x8(v);
+        } else {
+            sha512_compress_x4(v);
+        }
+        for (j = 0; j < q; j++) {
+            p = &lane[i + j];
+            for (k = 0; k < 8; k++) {
+                w[k] = v[k * xn + j];
+            }
+            memcpy(p->h, w, p->ctx->prm->n);
+        }
+    }
+}
+
 //  10.2.   SLH-DSA Using SHA2 for Security Category 1
 
 const slh_param_t slh_dsa_sha2_128s = { .alg_id ="SLH-DSA-SHA2-128s",
@@ -404,7 +495,13 @@ const slh_param_t slh_dsa_sha2_128s = { .alg_id ="SLH-DSA-SHA2-128s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_256_h_msg, .prf= sha256_prf, .prf_msg= sha256_prf_msg,
-    .h_f= sha256_f, .h_h= sha256_h, .h_t= sha256_tl
+    .h_f= sha256_f, .h_h= sha256_h, .h_t= sha256_tl,
+    .h_t_init= sha256_tl_init, .h_t_final= sha256_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha256_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_256_h_msg_init, .h_msg_final= sha2_256_h_msg_final,
+    .prf_msg_init= sha256_prf_msg_init, .prf_msg_final= sha256_prf_msg_final,
+    .msg_update= sha256_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_128f = { .alg_id ="SLH-DSA-SHA2-128f",
@@ -412,7 +509,13 @@ const slh_param_t slh_dsa_sha2_128f = { .alg_id ="SLH-DSA-SHA2-128f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_256_h_msg, .prf= sha256_prf, .prf_msg= sha256_prf_msg,
-    .h_f= sha256_f, .h_h= sha256_h, .h_t= sha256_tl
+    .h_f= sha256_f, .h_h= sha256_h, .h_t= sha256_tl,
+    .h_t_init= sha256_tl_init, .h_t_final= sha256_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha256_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_256_h_msg_init, .h_msg_final= sha2_256_h_msg_final,
+    .prf_msg_init= sha256_prf_msg_init, .prf_msg_final= sha256_prf_msg_final,
+    .msg_update= sha256_msg_update
 };
 
 //  10.3.   SLH-DSA Using SHA2 for Security Categories 3 and 5
@@ -422,7 +525,13 @@ const slh_param_t slh_dsa_sha2_192s = { .alg_id ="SLH-DSA-SHA2-192s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_t_init= sha512_tl_init, .h_t_final= sha512_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha512_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_192f = { .alg_id ="SLH-DSA-SHA2-192f",
@@ -430,7 +539,13 @@ const slh_param_t slh_dsa_sha2_192f = { .alg_id ="SLH-DSA-SHA2-192f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_t_init= sha512_tl_init, .h_t_final= sha512_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha512_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_256s = { .alg_id ="SLH-DSA-SHA2-256s",
@@ -438,7 +553,13 @@ const slh_param_t slh_dsa_sha2_256s = { .alg_id ="SLH-DSA-SHA2-256s",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_t_init= sha512_tl_init, .h_t_final= sha512_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha512_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 const slh_param_t slh_dsa_sha2_256f = { .alg_id ="SLH-DSA-SHA2-256f",
@@ -446,7 +567,13 @@ const slh_param_t slh_dsa_sha2_256f = { .alg_id ="SLH-DSA-SHA2-256f",
     .mk_ctx= sha2_mk_ctx, .chain= sha256_chain,
     .wots_chain= sha256_wots_chain, .fors_hash= sha256_fors_hash,
     .h_msg= sha2_512_h_msg, .prf= sha256_prf, .prf_msg= sha512_prf_msg,
-    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl
+    .h_f= sha256_f, .h_h= sha512_h, .h_t= sha512_tl,
+    .h_t_init= sha512_tl_init, .h_t_final= sha512_tl_final,
+    .prf_x= SLH_X(sha256_prf_x), .h_f_x= SLH_X(sha256_f_x),
+    .h_h_x= SLH_X(sha512_h_x), .chain_x= SLH_X(sha256_chain_x),
+    .h_msg_init= sha2_512_h_msg_init, .h_msg_final= sha2_512_h_msg_final,
+    .prf_msg_init= sha512_prf_msg_init, .prf_msg_final= sha512_prf_msg_final,
+    .msg_update= sha512_msg_update
 };
 
 //  SLOTH_SHA256
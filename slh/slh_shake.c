@@ -8,26 +8,35 @@
 #include "slh_ctx.h"
 #include "sha3_api.h"
 #include "slh_adrs.h"
+#include "slh_count.h"
 
 //  === 10.1.   SLH-DSA Using SHAKE
 
-//  Hmsg(R, PK.seed, PK.root, M) = SHAKE256(R || PK.seed || PK.root || M, 8m)
+//  SHAKE256(PK.seed || ADRS || M1 || M2) fits in a single block for all
+//  parameter sets; set up the padded state directly, word by word
 
-static void shake_h_msg( slh_ctx_t *ctx,
-                            uint8_t *h,
-                            const uint8_t *r,
-                            const uint8_t *m, size_t m_sz)
+static void shake_load( uint64_t *ks, const slh_ctx_t *ctx,
+                        const adrs_t *adrs,
+                        const uint8_t *m1, const uint8_t *m2)
 {
-    sha3_ctx_t sha3;
-    size_t  n = ctx->prm->n;
-
-    shake256_init(&sha3);
-    shake_update(&sha3, r, n);
-    shake_update(&sha3, ctx->pk_seed, n);
-    shake_update(&sha3, ctx->pk_root, n);
-    shake_update(&sha3, m, m_sz);
-
-    shake_out(&sha3, h, ctx->prm->m);
+    uint32_t k;
+    size_t n = ctx->prm->n;
+    const uint32_t r = (1600-256*2)/64;     //  SHAKE256 rate
+    uint32_t n8 = n / 8;                    //  number of words
+    uint32_t l = n8 + (32 / 8) + n8;        //  input length
+
+    memcpy(ks, ctx->pk_seed, n);            //  PK.seed
+    memcpy(ks + n8, adrs->u8, 32);          //  address
+    memcpy(ks + n8 + 4, m1, n);             //  message
+    if (m2 != NULL) {
+        memcpy(ks + l, m2, n);
+        l += n8;
+    }
+    for (k = l; k < 25; k++) {
+        ks[k] = 0;
+    }
+    ks[l] = 0x1F;                           //  shake padding
+    ks[r - 1] ^= UINT64_C(1) << 63;         //  rate padding
 }
 
 //  F(PK.seed, ADRS, M1 ) = SHAKE256(PK.seed || ADRS || M1, 8n)
@@ -36,56 +45,58 @@ static void shake_f( slh_ctx_t *ctx,
                         uint8_t *h,
                         const uint8_t *m1)
 {
-    sha3_ctx_t sha3;
-    size_t  n = ctx->prm->n;
-
-    shake256_init(&sha3);
-    shake_update(&sha3, ctx->pk_seed, n);
-    shake_update(&sha3, (const uint8_t *) ctx->adrs->u8, 32);
-    shake_update(&sha3, m1, n);
+    uint64_t ks[25];
 
-    shake_out(&sha3, h, n);
+    SLH_COUNT_HASH(SLH_CNT_F, ctx->adrs, 1);
+    shake_load(ks, ctx, ctx->adrs, m1, NULL);
+    keccak_f1600(ks);
+    memcpy(h, ks, ctx->prm->n);
 }
 
 //  PRF(PK.seed, SK.seed, ADRS) = SHAKE256(PK.seed || ADRS || SK.seed, 8n)
 
 static void shake_prf(slh_ctx_t *ctx, uint8_t *h)
 {
-    shake_f(ctx, h, ctx->sk_seed);
-}
+    uint64_t ks[25];
 
+    SLH_COUNT_HASH(SLH_CNT_PRF, ctx->adrs, 1);
+    shake_load(ks, ctx, ctx->adrs, ctx->sk_seed, NULL);
+    keccak_f1600(ks);
+    memcpy(h, ks, ctx->prm->n);
+}
 
-//  PRFmsg (SK.prf, opt_rand, M) = SHAKE256(SK.prf || opt_rand || M, 8n)
+//  T_l(PK.seed, ADRS, M ) = SHAKE256(PK.seed || ADRS || Ml, 8n)
 
-static void shake_prf_msg(  slh_ctx_t *ctx,
-                                uint8_t *h, const uint8_t *opt_rand,
-                                const uint8_t *m, size_t m_sz)
+static void shake_t( slh_ctx_t *ctx,
+                        uint8_t *h, const uint8_t *m, size_t m_sz)
 {
     sha3_ctx_t sha3;
     size_t  n = ctx->prm->n;
 
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
     shake256_init(&sha3);
-    shake_update(&sha3, ctx->sk_prf, n);
-    shake_update(&sha3, opt_rand, n);
+    shake_update(&sha3, ctx->pk_seed, n);
+    shake_update(&sha3, (const uint8_t *) ctx->adrs->u8, 32);
     shake_update(&sha3, m, m_sz);
 
     shake_out(&sha3, h, n);
 }
 
-//  T_l(PK.seed, ADRS, M ) = SHAKE256(PK.seed || ADRS || Ml, 8n)
+//  Incremental T_l: PK.seed || ADRS, then the values via msg_update()
 
-static void shake_t( slh_ctx_t *ctx,
-                        uint8_t *h, const uint8_t *m, size_t m_sz)
+static void shake_t_init(slh_ctx_t *ctx, slh_msg_t *st)
 {
-    sha3_ctx_t sha3;
     size_t  n = ctx->prm->n;
 
-    shake256_init(&sha3);
-    shake_update(&sha3, ctx->pk_seed, n);
-    shake_update(&sha3, (const uint8_t *) ctx->adrs->u8, 32);
-    shake_update(&sha3, m, m_sz);
+    SLH_COUNT_HASH(SLH_CNT_T, ctx->adrs, 1);
+    shake256_init(&st->sha3);
+    shake_update(&st->sha3, ctx->pk_seed, n);
+    shake_update(&st->sha3, (const uint8_t *) ctx->adrs->u8, 32);
+}
 
-    shake_out(&sha3, h, n);
+static void shake_t_final(slh_ctx_t *ctx, slh_msg_t *st, uint8_t *h)
+{
+    shake_out(&st->sha3, h, ctx->prm->n);
 }
 
 
@@ -95,16 +106,12 @@ static void shake_h( slh_ctx_t *ctx,
                         uint8_t *h,
                         const uint8_t *m1, const uint8_t *m2)
 {
-    sha3_ctx_t sha3;
-    size_t  n = ctx->prm->n;
-
-    shake256_init(&sha3);
-    shake_update(&sha3, ctx->pk_seed, n);
-    shake_update(&sha3, (const uint8_t *) ctx->adrs->u8, 32);
-    shake_update(&sha3, m1, n);
-    shake_update(&sha3, m2, n);
+    uint64_t ks[25];
 
-    shake_out(&sha3, h, n);
+    SLH_COUNT_HASH(SLH_CNT_H, ctx->adrs, 1);
+    shake_load(ks, ctx, ctx->adrs, m1, m2);
+    keccak_f1600(ks);
+    memcpy(h, ks, ctx->prm->n);
 }
 
 //  create a context
@@ -135,11 +142,23 @@ static void shake_mk_ctx(slh_ctx_t *ctx,
 
 //  chaining by processor (some optimizations)
 
+//  Within a chain, only the chained value and the hash address change from
+//  one F input block to the next. The block is set up once as a template;
+//  each step patches those words and copies the template to the state.
+//  The hash address is in the upper half of the fourth ADRS word.
+
+#define SHAKE_HA_WORD(n)    ((n) / 8 + 3)
+
+static inline uint64_t shake_ha_patch(uint64_t w, uint32_t x)
+{
+    return (w & UINT64_C(0xFFFFFFFF)) | ((uint64_t) rev8_be32(x) << 32);
+}
+
 static void shake_chain( slh_ctx_t *ctx, uint8_t *tmp, const uint8_t *x,
                             uint32_t i, uint32_t s)
 {
     uint32_t j, k;
-    uint64_t ks[25];
+    uint64_t ks[25], tk[25];
     size_t n = ctx->prm->n;
 
     if (s == 0) {                           //  no-op
@@ -147,32 +166,25 @@ static void shake_chain( slh_ctx_t *ctx, uint8_t *tmp, const uint8_t *x,
         return;
     }
 
-    const uint32_t r = (1600-256*2)/64;     //  SHAKE256 rate
     uint32_t n8 = n / 8;                    //  number of words
     uint32_t h = n8 + (32 / 8);             //  static part len
-    uint32_t l = h + n8;                    //  input length
+    uint32_t a = SHAKE_HA_WORD(n);          //  hash address word
+
+    SLH_COUNT_HASH(SLH_CNT_F, ctx->adrs, s);
+    adrs_set_hash_address(ctx, i);
+    shake_load(tk, ctx, ctx->adrs, x, NULL);
 
-    memcpy(ks + h, x, n);                   //  start node
     for (j = 0; j < s; j++) {
         if (j > 0) {
-            memcpy(ks + h, ks, n);          //  chaining
-        }
-        memcpy(ks, ctx->pk_seed, n);        //  PK.seed
-        adrs_set_hash_address(ctx, i + j);  //  address
-        memcpy(ks + n8, (const uint8_t *) ctx->adrs->u8, 32);
-
-        //  padding
-        ks[l] = 0x1F;                       //  shake padding
-        for (k = l + 1; k < r - 1; k++) {
-            ks[k] = 0;
-        }
-        ks[r - 1] = UINT64_C(1) << 63;      //  rate padding
-        for (k = r; k < 25; k++) {
-            ks[k] = 0;
+            for (k = 0; k < n8; k++) {      //  chaining
+                tk[h + k] = ks[k];
+            }
+            tk[a] = shake_ha_patch(tk[a], i + j);
         }
-
+        memcpy(ks, tk, sizeof(ks));
         keccak_f1600(ks);                   //  permutation
     }
+    adrs_set_hash_address(ctx, i + s - 1);
     memcpy(tmp, ks, n);
 }
 
@@ -206,6 +218,137 @@ static void shake_fors_hash( slh_ctx_t *ctx, uint8_t *tmp, uint32_t s)
     }
 }
 
+//  === Multi-buffer functions: four lanes at a time with keccak_f1600_x4()
+
+//  load SHAKE256(PK.seed || ADRS || M1 || M2) input block to lane j
+
+static void shake_x4_load(  uint64_t (*st)[4], uint32_t j,
+                            const slh_ctx_t *ctx, const adrs_t *adrs,
+                            const uint8_t *m1, const uint8_t *m2)
+{
+    uint32_t k;
+    uint64_t ks[25];
+
+    shake_load(ks, ctx, adrs, m1, m2);
+    for (k = 0; k < 25; k++) {
+        st[k][j] = ks[k];
+    }
+}
+
+//  get n-byte output of lane j
+
+static void shake_x4_out(uint8_t *h, uint64_t (*st)[4], uint32_t j, size_t n)
+{
+    uint32_t k;
+    uint64_t ks[SLH_MAX_N / 8];
+
+    for (k = 0; k < n / 8; k++) {
+        ks[k] = st[k][j];
+    }
+    memcpy(h, ks, n);
+}
+
+//  F, H, or PRF for l lanes. Unused lanes in the last group repeat lane 0.
+
+static void shake_fh_x( slh_lane_t *lane, uint32_t l, bool prf, bool hh)
+{
+    uint32_t i, j, q;
+    uint64_t st[25][4];
+    slh_lane_t *p;
+
+    for (i = 0; i < l; i++) {
+        SLH_COUNT_HASH(prf ? SLH_CNT_PRF : hh ? SLH_CNT_H : SLH_CNT_F,
+                        &lane[i].adrs, 1);
+    }
+
+    for (i = 0; i < l; i += 4) {
+        q = l - i < 4 ? l - i : 4;
+        for (j = 0; j < 4; j++) {
+            p = &lane[i + (j < q ? j : 0)];
+            shake_x4_load(  st, j, p->ctx, &p->adrs,
+                            prf ? p->ctx->sk_seed : p->m1,
+                            hh ? p->m2 : NULL);
+        }
+        keccak_f1600_x4(st);
+        for (j = 0; j < q; j++) {
+            p = &lane[i + j];
+            shake_x4_out(p->h, st, j, p->ctx->prm->n);
+        }
+    }
+}
+
+static void shake_prf_x(slh_lane_t *lane, uint32_t l)
+{
+    shake_fh_x(lane, l, true, false);
+}
+
+static void shake_f_x(slh_lane_t *lane, uint32_t l)
+{
+    shake_fh_x(lane, l, false, false);
+}
+
+static void shake_h_x(slh_lane_t *lane, uint32_t l)
+{
+    shake_fh_x(lane, l, false, true);
+}
+
+//  s chaining steps for l lanes, starting from the hash address of each
+
+//  As in shake_chain(), the four input blocks are set up once as a
+//  (transposed) template, and only the chained values and hash addresses
+//  are patched at each step. All lanes of a call have the same n.
+
+static void shake_chain_x(slh_lane_t *lane, uint32_t l, uint32_t s)
+{
+    uint32_t i, j, k, m, q;
+    uint64_t st[25][4], tk[25][4];
+    uint32_t a0[4];
+    slh_lane_t *p;
+    size_t n;
+
+    if (l == 0 || s == 0) {
+        for (i = 0; i < l; i++) {
+            memcpy(lane[i].h, lane[i].m1, lane[i].ctx->prm->n);
+        }
+        return;
+    }
+
+    for (i = 0; i < l; i++) {
+        SLH_COUNT_HASH(SLH_CNT_F, &lane[i].adrs, s);
+    }
+
+    n = lane[0].ctx->prm->n;
+    uint32_t n8 = n / 8;                    //  number of words
+    uint32_t h = n8 + (32 / 8);             //  chained value
+    uint32_t a = SHAKE_HA_WORD(n);          //  hash address word
+
+    for (i = 0; i < l; i += 4) {
+        q = l - i < 4 ? l - i : 4;
+        for (j = 0; j < 4; j++) {
+            p = &lane[i + (j < q ? j : 0)];
+            a0[j] = lane_get_hash_address(p);
+            shake_x4_load(tk, j, p->ctx, &p->adrs, p->m1, NULL);
+        }
+        for (k = 0; k < s; k++) {
+            if (k > 0) {
+                for (m = 0; m < n8; m++) {
+                    for (j = 0; j < 4; j++) {
+                        tk[h + m][j] = st[m][j];
+                    }
+                }
+                for (j = 0; j < 4; j++) {
+                    tk[a][j] = shake_ha_patch(tk[a][j], a0[j] + k);
+                }
+            }
+            memcpy(st, tk, sizeof(st));
+            keccak_f1600_x4(st);
+        }
+        for (j = 0; j < q; j++) {
+            shake_x4_out(lane[i + j].h, st, j, n);
+        }
+    }
+}
+
 //  parameter sets
 
 const slh_param_t slh_dsa_shake_128s = {    .alg_id ="SLH-DSA-SHAKE-128s",
@@ -213,7 +356,13 @@ const slh_param_t slh_dsa_shake_128s = {    .alg_id ="SLH-DSA-SHAKE-128s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_128f = {    .alg_id ="SLH-DSA-SHAKE-128f",
@@ -221,7 +370,13 @@ const slh_param_t slh_dsa_shake_128f = {    .alg_id ="SLH-DSA-SHAKE-128f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_192s = {    .alg_id ="SLH-DSA-SHAKE-192s",
@@ -229,7 +384,13 @@ const slh_param_t slh_dsa_shake_192s = {    .alg_id ="SLH-DSA-SHAKE-192s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_192f = {    .alg_id ="SLH-DSA-SHAKE-192f",
@@ -237,7 +398,13 @@ const slh_param_t slh_dsa_shake_192f = {    .alg_id ="SLH-DSA-SHAKE-192f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_256s = {    .alg_id ="SLH-DSA-SHAKE-256s",
@@ -245,7 +412,13 @@ const slh_param_t slh_dsa_shake_256s = {    .alg_id ="SLH-DSA-SHAKE-256s",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 const slh_param_t slh_dsa_shake_256f = {    .alg_id ="SLH-DSA-SHAKE-256f",
@@ -253,7 +426,13 @@ const slh_param_t slh_dsa_shake_256f = {    .alg_id ="SLH-DSA-SHAKE-256f",
     .mk_ctx= shake_mk_ctx, .chain= shake_chain,
     .wots_chain= shake_wots_chain, .fors_hash= shake_fors_hash,
     .h_msg= shake_h_msg, .prf= shake_prf, .prf_msg= shake_prf_msg,
-    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t
+    .h_f= shake_f, .h_h= shake_h, .h_t= shake_t,
+    .h_t_init= shake_t_init, .h_t_final= shake_t_final,
+    .prf_x= SLH_X(shake_prf_x), .h_f_x= SLH_X(shake_f_x),
+    .h_h_x= SLH_X(shake_h_x), .chain_x= SLH_X(shake_chain_x),
+    .h_msg_init= shake_h_msg_init, .h_msg_final= shake_h_msg_final,
+    .prf_msg_init= shake_prf_msg_init, .prf_msg_final= shake_prf_msg_final,
+    .msg_update= shake_msg_update
 };
 
 //  no SLOTH_KECCAK
@@ -0,0 +1,57 @@
+//  slh_stream.c
+//  Markku-Juhani O. Saarinen <mjos@iki.fi>.  See LICENSE.
+
+//  === Streaming (init / update / final) verification.
+
+#ifndef SLOTH
+
+#include "slh_ctx.h"
+#include <stdlib.h>
+
+//  Start verifying signature sig with public key pk.
+
+slh_vstream_t *slh_verify_init( const uint8_t *sig, const uint8_t *pk,
+                                const slh_param_t *prm)
+{
+    slh_vstream_t *vs;
+
+    vs = (slh_vstream_t *) calloc(1, sizeof(slh_vstream_t));
+    if (vs == NULL)
+        return NULL;
+    prm->mk_ctx(&vs->ctx, pk, NULL, prm);   //  (optional features cleared)
+    vs->sig = sig;
+
+    //  R is the first part of the signature
+    prm->h_msg_init(&vs->ctx, &vs->st, sig);
+
+    return vs;
+}
+
+//  Process the next m_sz bytes of the message.
+
+void slh_verify_update(slh_vstream_t *vs, const uint8_t *m, size_t m_sz)
+{
+    if (vs == NULL)
+        return;
+    vs->ctx.prm->msg_update(&vs->st, m, m_sz);
+}
+
+//  Finish and free *vs; returns the result of the verification.
+
+bool slh_verify_final(slh_vstream_t *vs)
+{
+    uint8_t digest[SLH_MAX_M];
+    bool sig_ok;
+
+    if (vs == NULL)
+        return false;
+
+    vs->ctx.prm->h_msg_final(&vs->ctx, &vs->st, digest, vs->sig);
+    sig_ok = slh_do_verify(&vs->ctx, vs->sig, digest);
+    free(vs);
+
+    return sig_ok;
+}
+
+//  SLOTH
+#endif